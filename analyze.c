@@ -0,0 +1,466 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "analyze.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Steganalysis of 24-bit BMPs.
+ *
+ * Chi-square: LSB replacement equalizes the counts of each value pair
+ * (2k, 2k + 1). The test runs over growing prefixes of the pixel data
+ * (payloads are embedded from the start), the estimated rate is the
+ * longest prefix that still looks equalized (p > 0.5).
+ *
+ * RS: samples of a channel form groups of 4 (sliding along the row, one
+ * group per byte, so the loop maps onto SIMD lanes); flipping the LSBs
+ * of the middle two with F1 (x ^ 1) or F-1 (((x + 1) ^ 1) - 1) makes a
+ * group smoother (singular) or rougher (regular). Counting this
+ * on the image and on its LSB-flipped version gives a quadratic whose
+ * root is the embedding rate (Fridrich, Goljan, Du).
+ */
+
+/* Sub-histograms used by add_to_histogram */
+#define HIST_COPIES 4
+
+typedef struct _RsCounts
+{
+    /* [0] = original image, [1] = all LSBs flipped; M / -M mask */
+    long regular[2][2];
+    long singular[2][2];
+} RsCounts;
+
+/* ---------------------------------------------------------------------
+ * upper_incomplete_gamma
+ * Regularized Q(a, x), series for x < a + 1 else continued fraction.
+ * -------------------------------------------------------------------*/
+static double upper_incomplete_gamma(double a, double x)
+{
+    if (x <= 0)
+        return 1.0;
+
+    double gln = lgamma(a);
+
+    if (x < a + 1)
+    {
+        double sum = 1.0 / a, del = sum, ap = a;
+        for (int n = 0; n < 500 && fabs(del) > fabs(sum) * 1e-12; n++)
+        {
+            ap += 1;
+            del *= x / ap;
+            sum += del;
+        }
+        return 1.0 - sum * exp(-x + a * log(x) - gln);
+    }
+
+    double b = x + 1 - a, c = 1e300, d = 1 / b, h = d;
+    for (int i = 1; i < 500; i++)
+    {
+        double an = -i * (i - a);
+        b += 2;
+        d = an * d + b;
+        if (fabs(d) < 1e-300)
+            d = 1e-300;
+        c = b + an / c;
+        if (fabs(c) < 1e-300)
+            c = 1e-300;
+        d = 1 / d;
+        double del = d * c;
+        h *= del;
+        if (fabs(del - 1) < 1e-12)
+            break;
+    }
+    return exp(-x + a * log(x) - gln) * h;
+}
+
+/* ---------------------------------------------------------------------
+ * chi_square_p
+ * p-value that the pair counts of the histogram are equalized.
+ * -------------------------------------------------------------------*/
+static double chi_square_p(unsigned int hist[][256])
+{
+    double chi = 0;
+    int categories = 0;
+
+    for (int k = 0; k < 128; k++)
+    {
+        double even = 0, odd = 0;
+        for (int h = 0; h < HIST_COPIES; h++)
+        {
+            even += hist[h][2 * k];
+            odd += hist[h][2 * k + 1];
+        }
+
+        double expected = (even + odd) / 2.0;
+        if (expected <= 4)
+            continue;
+
+        chi += (even - expected) * (even - expected) / expected;
+        categories++;
+    }
+
+    if (categories < 2)
+        return 0.0;
+
+    return upper_incomplete_gamma((categories - 1) / 2.0, chi / 2.0);
+}
+
+/* ---------------------------------------------------------------------
+ * add_to_histogram
+ * HIST_COPIES interleaved sub-histograms so runs of equal bytes do not
+ * serialize on one counter; they are only summed in chi_square_p.
+ * -------------------------------------------------------------------*/
+static void add_to_histogram(unsigned int hist[][256], const unsigned char *data, long len)
+{
+    long i = 0;
+
+    for (; i + 4 <= len; i += 4)
+    {
+        hist[0][data[i]]++;
+        hist[1][data[i + 1]]++;
+        hist[2][data[i + 2]]++;
+        hist[3][data[i + 3]]++;
+    }
+    for (; i < len; i++)
+        hist[0][data[i]]++;
+}
+
+/* ---------------------------------------------------------------------
+ * count_rs_groups
+ * RS groups are 4 consecutive samples of one channel (row bytes i, i+3,
+ * i+6, i+9), taken at every byte of the row (sliding groups), with the
+ * mask [0 1 1 0]. flip = 0 for the image, 1 for the image with every
+ * LSB flipped. Returns the first byte not handled.
+ * -------------------------------------------------------------------*/
+static long count_rs_groups_scalar(const unsigned char *row, long from, long to, int flip, RsCounts *rs)
+{
+    for (long i = from; i < to; i++)
+    {
+        int a = row[i] ^ flip, b = row[i + 3] ^ flip;
+        int e = row[i + 6] ^ flip, d = row[i + 9] ^ flip;
+
+        int bp = b ^ 1, ep = e ^ 1;
+        int bn = ((b + 1) ^ 1) - 1, en = ((e + 1) ^ 1) - 1;
+
+        int f = abs(b - a) + abs(e - b) + abs(d - e);
+        int fp = abs(bp - a) + abs(ep - bp) + abs(d - ep);
+        int fn = abs(bn - a) + abs(en - bn) + abs(d - en);
+
+        rs->regular[flip][0] += fp > f;
+        rs->singular[flip][0] += fp < f;
+        rs->regular[flip][1] += fn > f;
+        rs->singular[flip][1] += fn < f;
+    }
+
+    return to;
+}
+
+#ifdef __SSE2__
+/* |x| for 16-bit lanes (SSE2 has no pabsw) */
+static inline __m128i abs_epi16(__m128i x)
+{
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+/* Add the 16-bit lane counters into a 64-bit total */
+static inline long sum_epi16(__m128i x)
+{
+    short lanes[8];
+    long sum = 0;
+
+    _mm_storeu_si128((__m128i *)lanes, x);
+    for (int i = 0; i < 8; i++)
+        sum += lanes[i];
+    return sum;
+}
+
+/* ---------------------------------------------------------------------
+ * count_rs_groups_sse2
+ * 8 groups per step in 16-bit lanes. F1 = x + 1 - 2 (x & 1),
+ * F-1 = x - 1 + 2 (x & 1). Comparison masks are -1, so the lane
+ * counters are decremented and flushed every 4096 steps.
+ * -------------------------------------------------------------------*/
+static long count_rs_groups_sse2(const unsigned char *row, long len, int flip, RsCounts *rs)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i flip_mask = _mm_set1_epi8(flip);
+    long i = 0;
+
+    while (i + 8 <= len)
+    {
+        __m128i reg_pos = zero, sing_pos = zero, reg_neg = zero, sing_neg = zero;
+
+        for (int step = 0; step < 4096 && i + 8 <= len; step++, i += 8)
+        {
+            __m128i a = _mm_unpacklo_epi8(_mm_xor_si128(_mm_loadl_epi64((const __m128i *)(row + i)), flip_mask), zero);
+            __m128i b = _mm_unpacklo_epi8(_mm_xor_si128(_mm_loadl_epi64((const __m128i *)(row + i + 3)), flip_mask), zero);
+            __m128i e = _mm_unpacklo_epi8(_mm_xor_si128(_mm_loadl_epi64((const __m128i *)(row + i + 6)), flip_mask), zero);
+            __m128i d = _mm_unpacklo_epi8(_mm_xor_si128(_mm_loadl_epi64((const __m128i *)(row + i + 9)), flip_mask), zero);
+
+            __m128i b_odd = _mm_slli_epi16(_mm_and_si128(b, one), 1);
+            __m128i e_odd = _mm_slli_epi16(_mm_and_si128(e, one), 1);
+            __m128i bp = _mm_sub_epi16(_mm_add_epi16(b, one), b_odd);
+            __m128i ep = _mm_sub_epi16(_mm_add_epi16(e, one), e_odd);
+            __m128i bn = _mm_add_epi16(_mm_sub_epi16(b, one), b_odd);
+            __m128i en = _mm_add_epi16(_mm_sub_epi16(e, one), e_odd);
+
+            __m128i f = _mm_add_epi16(abs_epi16(_mm_sub_epi16(b, a)),
+                        _mm_add_epi16(abs_epi16(_mm_sub_epi16(e, b)), abs_epi16(_mm_sub_epi16(d, e))));
+            __m128i fp = _mm_add_epi16(abs_epi16(_mm_sub_epi16(bp, a)),
+                         _mm_add_epi16(abs_epi16(_mm_sub_epi16(ep, bp)), abs_epi16(_mm_sub_epi16(d, ep))));
+            __m128i fn = _mm_add_epi16(abs_epi16(_mm_sub_epi16(bn, a)),
+                         _mm_add_epi16(abs_epi16(_mm_sub_epi16(en, bn)), abs_epi16(_mm_sub_epi16(d, en))));
+
+            reg_pos = _mm_sub_epi16(reg_pos, _mm_cmpgt_epi16(fp, f));
+            sing_pos = _mm_sub_epi16(sing_pos, _mm_cmplt_epi16(fp, f));
+            reg_neg = _mm_sub_epi16(reg_neg, _mm_cmpgt_epi16(fn, f));
+            sing_neg = _mm_sub_epi16(sing_neg, _mm_cmplt_epi16(fn, f));
+        }
+
+        rs->regular[flip][0] += sum_epi16(reg_pos);
+        rs->singular[flip][0] += sum_epi16(sing_pos);
+        rs->regular[flip][1] += sum_epi16(reg_neg);
+        rs->singular[flip][1] += sum_epi16(sing_neg);
+    }
+
+    return i;
+}
+#endif
+
+static void count_rs_groups(const unsigned char *row, long row_bytes, int flip, RsCounts *rs)
+{
+    long len = row_bytes - 9, done = 0;
+
+    if (len <= 0)
+        return;
+
+#ifdef __SSE2__
+    /* Loads reach row[i + 9 + 7]: keep the vector part 7 bytes inside */
+    if (len > 7)
+        done = count_rs_groups_sse2(row, len - 7, flip, rs);
+#endif
+
+    count_rs_groups_scalar(row, done, len, flip, rs);
+}
+
+/* ---------------------------------------------------------------------
+ * rs_estimate
+ * Solves 2(d1 + d0) z^2 + (d-0 - d-1 - d1 - 3 d0) z + d0 - d-0 = 0,
+ * rate = z / (z - 1/2) for the root of smaller magnitude.
+ * -------------------------------------------------------------------*/
+static double rs_estimate(const RsCounts *rs)
+{
+    double d0 = rs->regular[0][0] - rs->singular[0][0];
+    double d1 = rs->regular[1][0] - rs->singular[1][0];
+    double dn0 = rs->regular[0][1] - rs->singular[0][1];
+    double dn1 = rs->regular[1][1] - rs->singular[1][1];
+
+    double a = 2 * (d1 + d0), b = dn0 - dn1 - d1 - 3 * d0, c = d0 - dn0;
+    double z;
+
+    if (fabs(a) < 1e-9)
+        z = (fabs(b) < 1e-9) ? 0 : -c / b;
+    else
+    {
+        double disc = b * b - 4 * a * c;
+        if (disc < 0)
+            disc = 0;
+        double z1 = (-b + sqrt(disc)) / (2 * a);
+        double z2 = (-b - sqrt(disc)) / (2 * a);
+        z = fabs(z1) < fabs(z2) ? z1 : z2;
+    }
+
+    double rate = (z - 0.5 == 0) ? 0 : z / (z - 0.5);
+    return rate < 0 ? 0 : (rate > 1 ? 1 : rate);
+}
+
+/* ---------------------------------------------------------------------
+ * analyze_image
+ * Reads the pixel array once (row by row, padding skipped) and feeds
+ * both tests.
+ * -------------------------------------------------------------------*/
+Status analyze_image(const char *fname, AnalysisResult *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->fname = fname;
+    result->status = e_failure;
+
+    FILE *fptr = fopen(fname, "rb");
+    if (fptr == NULL)
+        return e_failure;
+
+    if (read_bmp_info(fptr, &result->bmp) != e_success || result->bmp.bits_per_pixel != 24)
+    {
+        fclose(fptr);
+        return e_failure;
+    }
+
+    long width = result->bmp.width;
+    long height = labs((long)(int)result->bmp.height);
+    long row_bytes = width * 3;
+    long stride = (row_bytes + 3) & ~3L;
+    long total = row_bytes * height;
+
+    unsigned char *row = malloc(stride);
+    unsigned int hist[HIST_COPIES][256] = { 0 };
+    RsCounts rs = { 0 };
+    long done = 0, segment_end = total / CHI_SEGMENTS, segments = 0, flagged_prefix = 0;
+
+    fseek(fptr, result->bmp.pixel_offset, SEEK_SET);
+
+    for (long y = 0; row && y < height; y++)
+    {
+        if (fread(row, 1, stride, fptr) < row_bytes)
+            break;
+
+        /* Chi-square histogram, closing prefix segments as they fill */
+        for (long pos = 0; pos < row_bytes;)
+        {
+            long n = row_bytes - pos;
+            if (segments < CHI_SEGMENTS - 1 && done + n > segment_end)
+                n = segment_end - done;
+
+            add_to_histogram(hist, row + pos, n);
+            pos += n;
+            done += n;
+
+            if (segments < CHI_SEGMENTS - 1 && done == segment_end)
+            {
+                segments++;
+                if (chi_square_p(hist) > 0.5)
+                    flagged_prefix = done;
+                segment_end = total / CHI_SEGMENTS * (segments + 1);
+            }
+        }
+
+        /* RS groups on the image and on its LSB-flipped version */
+        count_rs_groups(row, row_bytes, 0, &rs);
+        count_rs_groups(row, row_bytes, 1, &rs);
+    }
+
+    if (done == total && total > 0)
+    {
+        result->chi_square_p = chi_square_p(hist);
+        if (result->chi_square_p > 0.5)
+            flagged_prefix = done;
+        result->chi_square_rate = (double)flagged_prefix / total;
+        result->rs_rate = rs_estimate(&rs);
+        result->status = e_success;
+    }
+
+    free(row);
+    fclose(fptr);
+    return result->status;
+}
+
+/*
+ * Thread pool: every worker takes the next unclaimed image index.
+ */
+typedef struct _AnalysisPool
+{
+    char **fnames;
+    AnalysisResult *results;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} AnalysisPool;
+
+static void *analysis_worker(void *arg)
+{
+    AnalysisPool *pool = arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        int i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (i >= pool->count)
+            break;
+
+        analyze_image(pool->fnames[i], &pool->results[i]);
+    }
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * do_analysis
+ * Screens all images, then prints one line per image in input order.
+ * -------------------------------------------------------------------*/
+Status do_analysis(char *fnames[], int count, uint threads)
+{
+    AnalysisPool pool = { fnames, NULL, count, 0 };
+    struct timespec start, end;
+    double bytes = 0;
+    int flagged = 0;
+
+    printf("\n🚀 ============= STEGANALYSIS STARTED ============== 🚀\n");
+
+    if (threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? cpus : 1;
+    }
+    if (threads > count)
+        threads = count;
+
+    pool.results = calloc(count, sizeof(AnalysisResult));
+    pthread_t *workers = calloc(threads, sizeof(pthread_t));
+    if (!pool.results || !workers)
+        return e_failure;
+
+    pthread_mutex_init(&pool.lock, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint started = 0;
+    for (; started < threads; started++)
+        if (pthread_create(&workers[started], NULL, analysis_worker, &pool) != 0)
+            break;
+
+    /* No thread at all: screen on the calling thread */
+    if (started == 0)
+        analysis_worker(&pool);
+
+    for (uint i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_mutex_destroy(&pool.lock);
+
+    for (int i = 0; i < count; i++)
+    {
+        AnalysisResult *r = &pool.results[i];
+
+        if (r->status != e_success)
+        {
+            printf("⚠️  %s : not a readable 24-bit BMP\n", r->fname);
+            continue;
+        }
+
+        double rate = r->rs_rate > r->chi_square_rate ? r->rs_rate : r->chi_square_rate;
+        int suspicious = rate > SUSPICIOUS_RATE;
+
+        bytes += (double)r->bmp.width * labs((long)(int)r->bmp.height) * 3;
+        flagged += suspicious;
+
+        printf("%s %s : est. rate %5.1f%% (chi-square %5.1f%%, p=%.3f | RS %5.1f%%)\n",
+               suspicious ? "🚨" : "✅", r->fname, rate * 100,
+               r->chi_square_rate * 100, r->chi_square_p, r->rs_rate * 100);
+    }
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\n📊 %d image(s), %d flagged, %u thread(s), %.1f MB/s\n",
+           count, flagged, threads, seconds > 0 ? bytes / seconds / 1e6 : 0);
+
+    free(workers);
+    free(pool.results);
+    return e_success;
+}
@@ -0,0 +1,41 @@
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include "types.h"
+#include "encode.h"
+
+/* Prefix steps of the sequential chi-square test */
+#define CHI_SEGMENTS 32
+
+/*
+ * Estimated rate above which an image is flagged. RS reads
+ * a few percent up to ~15% on some clean covers
+ */
+#define SUSPICIOUS_RATE 0.20
+
+/*
+ * Result of screening one image for LSB embedding
+ * (no MAGIC_STRING needed)
+ */
+typedef struct _AnalysisResult
+{
+    const char *fname;
+    Status status;
+    BmpInfo bmp;
+
+    /* Chi-square pairs-of-values test */
+    double chi_square_p;
+    double chi_square_rate;
+
+    /* RS (regular / singular groups) estimate */
+    double rs_rate;
+
+} AnalysisResult;
+
+/* Screen one image */
+Status analyze_image(const char *fname, AnalysisResult *result);
+
+/* Screen a corpus of images on a pool of threads */
+Status do_analysis(char *fnames[], int count, uint threads);
+
+#endif
@@ -0,0 +1,105 @@
+#include <stdlib.h>
+#include "arena.h"
+
+struct _ArenaBlock
+{
+    ArenaBlock *next;
+    size_t size;
+    size_t used;
+};
+
+/* Block header rounded up so the data after it stays aligned */
+#define ARENA_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+/* ---------------------------------------------------------------------
+ * arena_init
+ * -------------------------------------------------------------------*/
+void arena_init(Arena *arena)
+{
+    arena->blocks = NULL;
+    arena->high_water = 0;
+    arena->heap_allocs = 0;
+}
+
+/* ---------------------------------------------------------------------
+ * new_block
+ * -------------------------------------------------------------------*/
+static ArenaBlock *new_block(Arena *arena, size_t size)
+{
+    ArenaBlock *block = malloc(ARENA_HEADER + size);
+
+    if (block == NULL)
+        return NULL;
+
+    arena->heap_allocs++;
+    block->size = size;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    return block;
+}
+
+/* ---------------------------------------------------------------------
+ * arena_alloc
+ * Bumps the newest block, or starts a new one (twice the size of the
+ * last, at least ARENA_MIN_BLOCK) when it is full.
+ * -------------------------------------------------------------------*/
+void *arena_alloc(Arena *arena, size_t size)
+{
+    ArenaBlock *block = arena->blocks;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (block == NULL || block->size - block->used < size)
+    {
+        size_t grow = block ? block->size * 2 : ARENA_MIN_BLOCK;
+
+        if ((block = new_block(arena, grow > size ? grow : size)) == NULL)
+            return NULL;
+    }
+
+    void *ptr = (char *)block + ARENA_HEADER + block->used;
+    block->used += size;
+    return ptr;
+}
+
+/* ---------------------------------------------------------------------
+ * arena_reset
+ * With one block it is simply rewound. Several blocks mean the job
+ * outgrew it: they are replaced by one block holding the high water
+ * mark, so the next job of that size fits without new allocations.
+ * -------------------------------------------------------------------*/
+void arena_reset(Arena *arena)
+{
+    size_t used = 0;
+
+    for (ArenaBlock *block = arena->blocks; block; block = block->next)
+        used += block->size;
+
+    if (used > arena->high_water)
+        arena->high_water = used;
+
+    if (arena->blocks && arena->blocks->next)
+    {
+        arena_release(arena);
+        new_block(arena, arena->high_water);
+    }
+    else if (arena->blocks)
+    {
+        arena->blocks->used = 0;
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * arena_release
+ * -------------------------------------------------------------------*/
+void arena_release(Arena *arena)
+{
+    while (arena->blocks)
+    {
+        ArenaBlock *next = arena->blocks->next;
+
+        free(arena->blocks);
+        arena->blocks = next;
+    }
+}
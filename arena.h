@@ -0,0 +1,42 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include "types.h"
+
+/* Smallest block taken from the heap, allocations are 16-byte aligned */
+#define ARENA_MIN_BLOCK (64 * 1024)
+#define ARENA_ALIGN 16
+
+typedef struct _ArenaBlock ArenaBlock;
+
+/*
+ * Bump allocator owning the buffers of a job (pipeline ring,
+ * names, header scratch). Memory is given back
+ * all at once by arena_reset; after a job that needed more than
+ * one block the arena settles on a single block of that size,
+ * so repeated jobs of the same shape stop touching the heap.
+ */
+typedef struct _Arena
+{
+    ArenaBlock *blocks;
+    size_t high_water;
+
+    /* Heap allocations made so far (for the stats output) */
+    unsigned long heap_allocs;
+
+} Arena;
+
+/* Empty arena, nothing allocated yet */
+void arena_init(Arena *arena);
+
+/* size bytes valid until the next arena_reset, NULL if out of memory */
+void *arena_alloc(Arena *arena, size_t size);
+
+/* Forget all allocations, keeping (and merging) the memory */
+void arena_reset(Arena *arena);
+
+/* Return all memory to the heap */
+void arena_release(Arena *arena);
+
+#endif
@@ -0,0 +1,119 @@
+#include <time.h>
+#include "batch.h"
+
+/* ---------------------------------------------------------------------
+ * split_job_line
+ * Splits a job line into args[1..] (args[0] is a placeholder for the
+ * program name, like argv). Returns the word count including it, 0
+ * for blank / comment lines and -1 for too many words.
+ * -------------------------------------------------------------------*/
+static int split_job_line(char *line, char *args[])
+{
+    char *save;
+    int argc = 1;
+
+    args[0] = "batch";
+
+    for (char *tok = strtok_r(line, " \t\r\n", &save); tok; tok = strtok_r(NULL, " \t\r\n", &save))
+    {
+        if (argc == 1 && tok[0] == '#')
+            return 0;
+        if (argc == BATCH_MAX_ARGS)
+            return -1;
+        args[argc++] = tok;
+    }
+
+    args[argc] = NULL;
+    return argc == 1 ? 0 : argc;
+}
+
+/* ---------------------------------------------------------------------
+ * run_job
+ * One encode or decode job in the shared context.
+ * -------------------------------------------------------------------*/
+static Status run_job(int argc, char *args[], EncodeInfo *encInfo, DecodeInfo *decInfo)
+{
+    if (strcmp(args[1], "-e") == 0 && (argc == 4 || argc == 5))
+    {
+        if (read_and_validate_encode_args(args, encInfo) == e_success)
+            return do_encoding(encInfo);
+    }
+    else if (strcmp(args[1], "-d") == 0 && (argc == 3 || argc == 4))
+    {
+        if (read_and_validate_decode_args(args, decInfo) == e_success)
+            return do_decoding(decInfo);
+    }
+    else
+    {
+        printf("❌ ERROR: Batch jobs are \"-e <image> <secret> [output]\" or \"-d <stego> [output]\"\n");
+    }
+
+    return e_failure;
+}
+
+/* ---------------------------------------------------------------------
+ * do_batch
+ * -------------------------------------------------------------------*/
+Status do_batch(const char *jobs_fname, const StegoOptions *opts, StegoJob *job)
+{
+    FILE *fptr = fopen(jobs_fname, "r");
+    char line[BATCH_LINE_MAX];
+    char *args[BATCH_MAX_ARGS + 1];
+    EncodeInfo encInfo = { 0 };
+    DecodeInfo decInfo = { 0 };
+    long jobs = 0, failed = 0;
+    unsigned long first_allocs = 0;
+    struct timespec start, end;
+
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        printf("❌ ERROR: Unable to open %s\n", jobs_fname);
+        return e_failure;
+    }
+
+    encInfo.opts = decInfo.opts = opts;
+    encInfo.job = decInfo.job = job;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (fgets(line, sizeof(line), fptr) != NULL)
+    {
+        int argc = split_job_line(line, args);
+
+        if (argc == 0)
+            continue;
+
+        reset_job(job);
+
+        if (argc < 0)
+            printf("❌ ERROR: Too many words in batch job %ld\n", jobs + 1);
+
+        if (argc < 0 || run_job(argc, args, &encInfo, &decInfo) != e_success)
+            failed++;
+
+        if (++jobs == 1)
+            first_allocs = job_heap_allocs(job);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fclose(fptr);
+
+    unsigned long uncounted = job->uncounted_streams;
+
+    if (close_job(job) != e_success)
+        failed++;
+
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("\n📊 %ld job(s), %ld failed, %.0f jobs/s\n", jobs, failed, secs > 0 ? jobs / secs : 0.0);
+    if (uncounted == 0)
+        printf("🧮 Heap allocations : %lu in the first job, %lu in the other %ld\n",
+               first_allocs, job_heap_allocs(job) - first_allocs, jobs > 0 ? jobs - 1 : 0);
+    else
+        printf("🧮 Heap allocations : not covered, %lu FEC / PNG stream(s) allocate inside libc and zlib\n"
+               "   (job context alone: %lu in the first job, %lu in the other %ld)\n",
+               uncounted, first_allocs, job_heap_allocs(job) - first_allocs, jobs > 0 ? jobs - 1 : 0);
+
+    return failed == 0 ? e_success : e_failure;
+}
@@ -0,0 +1,17 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "types.h"
+#include "encode.h"
+
+/* Words of one job line: "-e <image> <secret> [output]" / "-d <stego> [output]" */
+#define BATCH_MAX_ARGS 5
+#define BATCH_LINE_MAX 4096
+
+/*
+ * Run every job of jobs_fname in one reused context: the same
+ * EncodeInfo / DecodeInfo, streams and arena serve all of them
+ */
+Status do_batch(const char *jobs_fname, const StegoOptions *opts, StegoJob *job);
+
+#endif
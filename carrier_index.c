@@ -0,0 +1,455 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "carrier_index.h"
+#include "encode.h"
+
+/*
+ * In-memory view of an index file (mmap'ed), or of the entries being
+ * built; paths points at the path blob.
+ */
+typedef struct _CarrierIndex
+{
+    IndexRecord *records;
+    uint32_t count;
+    const char *paths;
+    uint32_t paths_size;
+
+    /* mapping of an existing index file */
+    void *map;
+    size_t map_size;
+} CarrierIndex;
+
+/* Entry of a fresh scan, before the path blob is laid out */
+typedef struct _ScanEntry
+{
+    IndexRecord record;
+    char *path;
+} ScanEntry;
+
+/* File modification time in nanoseconds */
+static int64_t stat_mtime(const struct stat *st)
+{
+    return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+}
+
+/* ---------------------------------------------------------------------
+ * open_index
+ * Maps index_fname and checks its header, and that every record's
+ * path lies inside the path blob. Fails if there is none.
+ * -------------------------------------------------------------------*/
+static Status open_index(const char *index_fname, CarrierIndex *index)
+{
+    struct stat st;
+    memset(index, 0, sizeof(*index));
+
+    int fd = open(index_fname, O_RDONLY);
+    if (fd < 0)
+        return e_failure;
+
+    if (fstat(fd, &st) != 0 || st.st_size < sizeof(IndexHeader))
+    {
+        close(fd);
+        return e_failure;
+    }
+
+    index->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (index->map == MAP_FAILED)
+    {
+        index->map = NULL;
+        return e_failure;
+    }
+    index->map_size = st.st_size;
+
+    const IndexHeader *header = index->map;
+    size_t records_size = (size_t)header->count * sizeof(IndexRecord);
+
+    if (memcmp(header->magic, INDEX_MAGIC, 4) != 0 || header->version != INDEX_VERSION
+        || sizeof(IndexHeader) + records_size + header->paths_size != st.st_size)
+    {
+        munmap(index->map, index->map_size);
+        index->map = NULL;
+        return e_failure;
+    }
+
+    const IndexRecord *records = (const IndexRecord *)((char *)index->map + sizeof(IndexHeader));
+
+    for (uint32_t i = 0; i < header->count; i++)
+    {
+        if ((uint64_t)records[i].path_offset + records[i].path_len > header->paths_size)
+        {
+            munmap(index->map, index->map_size);
+            index->map = NULL;
+            return e_failure;
+        }
+    }
+
+    index->count = header->count;
+    index->records = (IndexRecord *)records;
+    index->paths = (const char *)index->records + records_size;
+    index->paths_size = header->paths_size;
+    return e_success;
+}
+
+static void close_index(CarrierIndex *index)
+{
+    if (index->map)
+        munmap(index->map, index->map_size);
+    index->map = NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * find_by_path
+ * Old entries are looked up through a path-sorted array of pointers,
+ * built once per refresh.
+ * -------------------------------------------------------------------*/
+static const CarrierIndex *sort_index;
+
+static int compare_record_paths(const void *a, const void *b)
+{
+    const IndexRecord *ra = *(IndexRecord *const *)a, *rb = *(IndexRecord *const *)b;
+    uint32_t len = ra->path_len < rb->path_len ? ra->path_len : rb->path_len;
+    int cmp = memcmp(sort_index->paths + ra->path_offset, sort_index->paths + rb->path_offset, len);
+
+    return cmp ? cmp : (int)ra->path_len - (int)rb->path_len;
+}
+
+static const IndexRecord *find_by_path(const CarrierIndex *index, IndexRecord **by_path, const char *path)
+{
+    size_t path_len = strlen(path);
+    long lo = 0, hi = (long)index->count - 1;
+
+    while (lo <= hi)
+    {
+        long mid = (lo + hi) / 2;
+        const IndexRecord *r = by_path[mid];
+        uint32_t len = r->path_len < path_len ? r->path_len : path_len;
+        int cmp = memcmp(index->paths + r->path_offset, path, len);
+
+        if (cmp == 0)
+            cmp = (int)r->path_len - (int)path_len;
+        if (cmp == 0)
+            return r;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * scan_cover
+ * Reads the BMP header of one cover. Only 24-bit BMPs are indexed.
+ * -------------------------------------------------------------------*/
+static Status scan_cover(const char *path, IndexRecord *record)
+{
+    BmpInfo info;
+    FILE *fptr = fopen(path, "rb");
+
+    if (fptr == NULL)
+        return e_failure;
+
+    Status status = read_bmp_info(fptr, &info);
+    fclose(fptr);
+
+    if (status != e_success || info.bits_per_pixel != 24)
+        return e_failure;
+
+    memset(record, 0, sizeof(*record));
+    record->width = info.width;
+    record->height = info.height;
+    record->bits_per_pixel = info.bits_per_pixel;
+    record->pixel_offset = info.pixel_offset;
+
+    /* Same rule as get_image_size_for_bmp */
+    record->pixel_bytes = (uint)(info.width * info.height * 3);
+
+    return e_success;
+}
+
+static int compare_capacity(const void *a, const void *b)
+{
+    const ScanEntry *ea = a, *eb = b;
+
+    if (ea->record.pixel_bytes != eb->record.pixel_bytes)
+        return ea->record.pixel_bytes < eb->record.pixel_bytes ? -1 : 1;
+    return strcmp(ea->path, eb->path);
+}
+
+/* ---------------------------------------------------------------------
+ * write_index
+ * Writes entries (sorted by capacity) to a temp file and renames it
+ * over index_fname, so readers never see a half written index.
+ * -------------------------------------------------------------------*/
+static Status write_index(const char *index_fname, ScanEntry *entries, uint32_t count)
+{
+    IndexHeader header;
+    char tmp_fname[strlen(index_fname) + 5];
+    uint32_t offset = 0;
+
+    qsort(entries, count, sizeof(ScanEntry), compare_capacity);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        entries[i].record.path_offset = offset;
+        entries[i].record.path_len = strlen(entries[i].path);
+        offset += entries[i].record.path_len;
+    }
+
+    memcpy(header.magic, INDEX_MAGIC, 4);
+    header.version = INDEX_VERSION;
+    header.count = count;
+    header.paths_size = offset;
+
+    sprintf(tmp_fname, "%s.tmp", index_fname);
+    FILE *fptr = fopen(tmp_fname, "wb");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        return e_failure;
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, fptr) == 1;
+    for (uint32_t i = 0; ok && i < count; i++)
+        ok = fwrite(&entries[i].record, sizeof(IndexRecord), 1, fptr) == 1;
+    for (uint32_t i = 0; ok && i < count; i++)
+        ok = fwrite(entries[i].path, 1, entries[i].record.path_len, fptr) == entries[i].record.path_len;
+
+    if (fclose(fptr) != 0 || !ok || rename(tmp_fname, index_fname) != 0)
+    {
+        perror("index");
+        remove(tmp_fname);
+        return e_failure;
+    }
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * do_build_index
+ * One pass over cover_dir. Covers whose mtime and size match the
+ * existing index are reused without opening them.
+ * -------------------------------------------------------------------*/
+Status do_build_index(const char *cover_dir, const char *index_fname)
+{
+    CarrierIndex old;
+    IndexRecord **by_path = NULL;
+    ScanEntry *entries = NULL;
+    uint32_t count = 0, allocated = 0, reused = 0, scanned = 0, kept = 0;
+    Status status = e_failure;
+
+    printf("\n🚀 ============ INDEX BUILD STARTED ============ 🚀\n");
+
+    DIR *dir = opendir(cover_dir);
+    if (dir == NULL)
+    {
+        perror("opendir");
+        fprintf(stderr, "❌ ERROR: Unable to open %s\n", cover_dir);
+        return e_failure;
+    }
+
+    if (open_index(index_fname, &old) == e_success && old.count > 0)
+    {
+        by_path = malloc(old.count * sizeof(IndexRecord *));
+        if (by_path)
+        {
+            for (uint32_t i = 0; i < old.count; i++)
+                by_path[i] = &old.records[i];
+            sort_index = &old;
+            qsort(by_path, old.count, sizeof(IndexRecord *), compare_record_paths);
+        }
+    }
+
+    struct dirent *dirent;
+    int failed = 0;
+    while (!failed && (dirent = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(dirent->d_name);
+        if (len < 4 || strcmp(dirent->d_name + len - 4, ".bmp") != 0)
+            continue;
+
+        char path[strlen(cover_dir) + len + 2];
+        struct stat st;
+        sprintf(path, "%s/%s", cover_dir, dirent->d_name);
+
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+            continue;
+
+        if (count == allocated)
+        {
+            allocated = allocated ? allocated * 2 : 64;
+            ScanEntry *grown = realloc(entries, allocated * sizeof(ScanEntry));
+            if (grown == NULL)
+            {
+                failed = 1;
+                break;
+            }
+            entries = grown;
+        }
+
+        /* Absolute path, so the index works from any directory */
+        char *full_path = realpath(path, NULL);
+        if (full_path == NULL)
+            continue;
+
+        ScanEntry *entry = &entries[count];
+        const IndexRecord *known = by_path ? find_by_path(&old, by_path, full_path) : NULL;
+
+        if (known && known->mtime == stat_mtime(&st) && known->file_size == st.st_size)
+        {
+            entry->record = *known;
+            reused++;
+        }
+        else if (scan_cover(full_path, &entry->record) == e_success)
+            scanned++;
+        else
+        {
+            free(full_path);
+            continue;
+        }
+
+        entry->record.mtime = stat_mtime(&st);
+        entry->record.file_size = st.st_size;
+        entry->path = full_path;
+        count++;
+
+        /* Old entries still present, reused or rescanned */
+        if (known)
+            kept++;
+    }
+
+    if (!failed)
+        status = write_index(index_fname, entries, count);
+
+    if (status == e_success)
+    {
+        printf("📚 Covers indexed : %u (%u unchanged, %u scanned, %u dropped)\n",
+               count, reused, scanned, old.count - kept);
+        printf("\n🎉 Index written to %s\n", index_fname);
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+        free(entries[i].path);
+    free(entries);
+    free(by_path);
+    close_index(&old);
+    closedir(dir);
+
+    if (status != e_success)
+        printf("❌ Index build failed.\n");
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * get_carrier_bytes_needed
+ * Image bytes the encoder will insist on for this secret: the plain
+ * check_capacity rule, plus the FEC / matrix layout when enabled.
+ * -------------------------------------------------------------------*/
+long get_carrier_bytes_needed(const StegoOptions *opts, long extn_size, long secret_size)
+{
+    long needed = get_required_capacity(extn_size, secret_size) + 1;
+
+    if (opts->fec_parity > 0)
+    {
+        long codewords = fec_codeword_count(4 + extn_size + 4 + secret_size, opts->fec_parity);
+        long fec = (FEC_HEADER_SIZE * FEC_HEADER_COPIES + codewords * FEC_CODEWORD_LEN) * 8 + 1;
+        needed = fec > needed ? fec : needed;
+    }
+    else if (opts->matrix_k > 0)
+    {
+        MatrixCode code;
+        matrix_init(&code, opts->matrix_k);
+
+        long matrix = (strlen(MATRIX_MAGIC_STRING) + 1 + extn_size) * 8 + 32 + 32
+                      + matrix_carrier_bytes(&code, secret_size);
+        needed = matrix > needed ? matrix : needed;
+    }
+
+    return needed;
+}
+
+/* ---------------------------------------------------------------------
+ * select_carrier_from_index
+ * Binary search for the first record with pixel_bytes >= needed, then
+ * the first candidate whose file is unchanged since indexing.
+ * -------------------------------------------------------------------*/
+Status select_carrier_from_index(const char *index_fname, long needed, char *path, size_t path_size)
+{
+    CarrierIndex index;
+
+    if (open_index(index_fname, &index) != e_success)
+    {
+        printf("❌ ERROR: %s is not a cover index (build it with -i)\n", index_fname);
+        return e_failure;
+    }
+
+    uint32_t lo = 0, hi = index.count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index.records[mid].pixel_bytes < (uint64_t)needed)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (uint32_t i = lo; i < index.count; i++)
+    {
+        const IndexRecord *r = &index.records[i];
+        struct stat st;
+
+        if (r->path_len >= path_size)
+            continue;
+
+        memcpy(path, index.paths + r->path_offset, r->path_len);
+        path[r->path_len] = '\0';
+
+        if (stat(path, &st) != 0)
+        {
+            printf("⚠️  %s is missing, skipped\n", path);
+            continue;
+        }
+
+        if (stat_mtime(&st) == r->mtime && st.st_size == r->file_size)
+        {
+            printf("🎯 Carrier selected : %s (%llu image bytes, %ld needed)\n",
+                   path, (unsigned long long)r->pixel_bytes, needed);
+            close_index(&index);
+            return e_success;
+        }
+
+        printf("⚠️  %s changed since indexing, skipped\n", path);
+    }
+
+    close_index(&index);
+    printf("❌ ERROR: No indexed cover can hold %ld image bytes\n", needed);
+    return e_failure;
+}
+
+/* ---------------------------------------------------------------------
+ * select_carrier_for_secret
+ * -------------------------------------------------------------------*/
+Status select_carrier_for_secret(const StegoOptions *opts, const char *secret_fname, char *path, size_t path_size)
+{
+    const char *extn = strrchr(secret_fname, '.');
+    struct stat st;
+
+    if (extn == NULL || stat(secret_fname, &st) != 0)
+    {
+        printf("❌ ERROR: Unable to read secret file %s\n", secret_fname);
+        return e_failure;
+    }
+
+    return select_carrier_from_index(opts->index_fname,
+                                     get_carrier_bytes_needed(opts, strlen(extn), st.st_size),
+                                     path, path_size);
+}
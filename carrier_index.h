@@ -0,0 +1,58 @@
+#ifndef CARRIER_INDEX_H
+#define CARRIER_INDEX_H
+
+#include <stdint.h>
+#include "types.h"
+#include "options.h"
+
+/*
+ * On-disk capacity index over a directory of cover BMPs:
+ *
+ *   IndexHeader | IndexRecord[count] (sorted by pixel_bytes) | paths
+ *
+ * Paths are absolute (realpath of each cover, so the index can be
+ * used from any directory), stored back to back (not NUL terminated)
+ * and referenced by offset / length. Sorted by pixel_bytes, one binary
+ * search finds the smallest cover that fits.
+ */
+
+#define INDEX_MAGIC "STIX"
+#define INDEX_VERSION 2
+
+typedef struct _IndexHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t paths_size;
+} IndexHeader;
+
+typedef struct _IndexRecord
+{
+    int64_t mtime;          /* nanoseconds */
+    int64_t file_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bits_per_pixel;
+    uint32_t pixel_offset;
+
+    /* Image bytes usable for embedding (what check_capacity compares) */
+    uint64_t pixel_bytes;
+
+    uint32_t path_offset;
+    uint32_t path_len;
+} IndexRecord;
+
+/* Scan cover_dir and (re)write index_fname, reusing unchanged entries */
+Status do_build_index(const char *cover_dir, const char *index_fname);
+
+/* Image bytes a cover needs to hide a secret with the given options */
+long get_carrier_bytes_needed(const StegoOptions *opts, long extn_size, long secret_size);
+
+/* Smallest indexed cover with at least needed image bytes */
+Status select_carrier_from_index(const char *index_fname, long needed, char *path, size_t path_size);
+
+/* Carrier for secret_fname from opts->index_fname */
+Status select_carrier_for_secret(const StegoOptions *opts, const char *secret_fname, char *path, size_t path_size);
+
+#endif
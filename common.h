@@ -4,4 +4,29 @@
 /* Magic string to identify whether stegged or not */
 #define MAGIC_STRING "#*"
 
+/* Longest secret file extension (with the dot) the decoder accepts */
+#define MAX_EXTN_SIZE 9
+
+/*
+ * Magic string of Reed-Solomon protected images. Its header
+ * (magic, parity symbols, message length) is stored
+ * FEC_HEADER_COPIES times and read back by bitwise majority
+ */
+#define FEC_MAGIC_STRING "#F"
+#define FEC_HEADER_SIZE 7
+#define FEC_HEADER_COPIES 3
+
+/*
+ * Magic string of matrix embedded images: followed by one
+ * byte k, the plain extn / size header, then the data in
+ * (1, 2^k - 1, k) Hamming code blocks
+ */
+#define MATRIX_MAGIC_STRING "#M"
+
+/*
+ * Magic string of Y4M video carriers: followed by a 32-bit extn
+ * size, the extn and a 64-bit size, all in the first frame
+ */
+#define VIDEO_MAGIC_STRING "#V"
+
 #endif
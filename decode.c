@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include "decode.h"
 
 /* =======================================================================
@@ -6,46 +7,36 @@
  * =======================================================================*/
 Status read_and_validate_decode_args(char* argv[], DecodeInfo *decInfo)
 {
-    /* Validate input BMP */
-    if (!strstr(argv[2], ".bmp"))
+    /* Validate input BMP / PNG */
+    decInfo->is_png = is_png_name(argv[2]);
+    const char *suffix = decInfo->is_png ? ".png" : ".bmp";
+
+    if (!strcasestr(argv[2], suffix))
     {
-        printf("❌ ERROR: Source image must be a .bmp file\n");
+        printf("❌ ERROR: Source image must be a .bmp or .png file\n");
         return e_failure;
     }
 
     int len = strlen(argv[2]);
-    if(len < 4 || strcmp(argv[2] + len - 4, ".bmp") != 0){
-        printf("❌ ERROR: Invalid output \".bmp\" file\n");
+    if(len < 4 || strcasecmp(argv[2] + len - 4, suffix) != 0){
+        printf("❌ ERROR: Invalid output \"%s\" file\n", suffix);
         printf("🗃️  %s\n",argv[2]);
         return e_failure;
     }
     decInfo->src_fname = argv[2];
 
-    /* Check output filename argument */
-    if (argv[3] != NULL)
-    {
-        /* Allocate memory for output filename */
-        decInfo->secret_fname = malloc(20);
-
-        if (!decInfo->secret_fname)
-            return e_failure;
-
-        /* Copy user-provided name */
-        strcpy(decInfo->secret_fname, argv[3]);
-
-        /* Remove extension, if present */
-        char *dot = strchr(decInfo->secret_fname, '.');
-        if (dot)
-            *dot = '\0';
-
-        return e_success;
-    }
-
-    /* Default filename if not provided */
-    decInfo->secret_fname = malloc(20);
+    /* Output name buffer from the job arena, the extension is appended later */
+    decInfo->secret_fname = arena_alloc(&decInfo->job->arena, JOB_NAME_MAX);
     if (!decInfo->secret_fname)
         return e_failure;
-    strcpy(decInfo->secret_fname, "dec_data");
+
+    /* User-provided name, or the default */
+    snprintf(decInfo->secret_fname, JOB_NAME_MAX, "%s", argv[3] != NULL ? argv[3] : "dec_data");
+
+    /* Remove extension, if present */
+    char *dot = strchr(decInfo->secret_fname, '.');
+    if (dot)
+        *dot = '\0';
 
     return e_success;
 }
@@ -53,11 +44,20 @@ Status read_and_validate_decode_args(char* argv[], DecodeInfo *decInfo)
 
 /* =======================================================================
  *  file_open
- *  Opens source BMP for reading.
+ *  Opens source BMP (or PNG pixel stream) for reading.
  * =======================================================================*/
 Status file_open(DecodeInfo *decInfo)
 {
-    decInfo->fptr_src_image = fopen(decInfo->src_fname, "rb");
+    decInfo->pixel_offset = decInfo->is_png ? 0 : 54;
+    if (decInfo->is_png)
+    {
+        PngInfo png;
+        decInfo->fptr_src_image = png_open_pixels(decInfo->src_fname, &png);
+        decInfo->job->uncounted_streams++;
+        decInfo->pixel_bytes = png.pixel_bytes;
+    }
+    else
+        decInfo->fptr_src_image = job_fopen(decInfo->job, e_job_src, decInfo->src_fname, "rb");
 
     if (decInfo->fptr_src_image == NULL)
     {
@@ -66,6 +66,12 @@ Status file_open(DecodeInfo *decInfo)
         return e_failure;
     }
 
+    if (!decInfo->is_png)
+    {
+        fseek(decInfo->fptr_src_image, 0, SEEK_END);
+        decInfo->pixel_bytes = ftell(decInfo->fptr_src_image) - decInfo->pixel_offset;
+    }
+
     return e_success;
 }
 
@@ -87,12 +93,12 @@ char decode_byte_to_lsb(unsigned char *buff)
  *  decode_magic_string
  *  Reads and verifies MAGIC_STRING from BMP.
  * =======================================================================*/
-Status decode_magic_string(FILE *fptr_src)
+Status decode_magic_string(FILE *fptr_src, uint pixel_offset)
 {
-    fseek(fptr_src, 54, SEEK_SET);
+    fseek(fptr_src, pixel_offset, SEEK_SET);
 
     int len = strlen(MAGIC_STRING);
-    char str[len + 1];
+    char str[sizeof(MAGIC_STRING)];
     char buff[8];
 
     for (int i = 0; i < len; i++)
@@ -107,6 +113,38 @@ Status decode_magic_string(FILE *fptr_src)
     return (strcmp(str, MAGIC_STRING) == 0) ? e_success : e_failure;
 }
 
+/* =======================================================================
+ *  decode_matrix_header
+ *  Reads MATRIX_MAGIC_STRING and k of a matrix embedded image.
+ * =======================================================================*/
+Status decode_matrix_header(DecodeInfo *decInfo)
+{
+    int len = strlen(MATRIX_MAGIC_STRING);
+    char str[sizeof(MATRIX_MAGIC_STRING)];
+    unsigned char buff[8];
+
+    fseek(decInfo->fptr_src_image, decInfo->pixel_offset, SEEK_SET);
+
+    for (int i = 0; i <= len; i++)
+    {
+        if (fread(buff, sizeof(buff), 1, decInfo->fptr_src_image) != 1)
+            return e_failure;
+        str[i] = decode_byte_to_lsb(buff);
+    }
+
+    int k = str[len];
+    str[len] = '\0';
+
+    if (strcmp(str, MATRIX_MAGIC_STRING) != 0 || k < MATRIX_MIN_K || k > MATRIX_MAX_K)
+        return e_failure;
+
+    decInfo->matrix_k = k;
+    matrix_init(&decInfo->matrix, k);
+
+    printf("🧮 Matrix embedded image: %d bits per %d image bytes.\n", k, decInfo->matrix.n);
+    return e_success;
+}
+
 /* =======================================================================
  *  decode_size_to_lsb
  *  Extracts 32-bit integer from 32 LSBs of image bytes.
@@ -137,14 +175,32 @@ Status decode_extn_size(DecodeInfo *decInfo)
     return e_success;
 }
 
+/* =======================================================================
+ *  append_extn
+ *  Adds the decoded extension to the output name, never past its buffer.
+ * =======================================================================*/
+static void append_extn(DecodeInfo *decInfo, const char *extn)
+{
+    size_t len = strlen(decInfo->secret_fname);
+
+    snprintf(decInfo->secret_fname + len, JOB_NAME_MAX - len, "%s", extn);
+}
+
 /* =======================================================================
  *  decode_extn
  *  Reads and reconstructs extension (like ".txt").
  * =======================================================================*/
 Status decode_extn(DecodeInfo *decInfo)
 {
-    char str[10];
+    char str[MAX_EXTN_SIZE + 1];
     int i = 0;
+
+    if (decInfo->extn_size < 0 || decInfo->extn_size >= sizeof(str))
+    {
+        printf("❌ ERROR: Invalid extension size %d\n", decInfo->extn_size);
+        return e_failure;
+    }
+
     for (i=0; i < decInfo->extn_size; i++)
     {
         unsigned char buff[8];
@@ -156,11 +212,11 @@ Status decode_extn(DecodeInfo *decInfo)
 
     printf("📝 Decoded Extension : %s\n", str);
 
-    strcat(decInfo->secret_fname, str);
+    append_extn(decInfo, str);
 
     printf("📄 Final Output Filename : %s\n", decInfo->secret_fname);
 
-    decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
+    decInfo->fptr_secret = job_fopen(decInfo->job, e_job_secret, decInfo->secret_fname, "w");
 
     if (decInfo->fptr_secret == NULL)
     {
@@ -188,25 +244,242 @@ Status decode_secret_data_size(DecodeInfo *decInfo)
     return e_success;
 }
 
+/* =======================================================================
+ *  Pipeline stages for decode_secret_data
+ *  read : next block of stego image bytes
+ *  embed: extract the hidden bytes from their LSBs (or Hamming syndromes)
+ *  write: block of secret bytes
+ * =======================================================================*/
+static Status read_stego_block(void *ctx, PipelineSlot *slot)
+{
+    DecodeInfo *decInfo = ctx;
+
+    if (fread(slot->carrier, 1, slot->carrier_len, decInfo->fptr_src_image) != slot->carrier_len)
+        return e_failure;
+
+    return e_success;
+}
+
+static Status extract_secret_block(void *ctx, PipelineSlot *slot)
+{
+    for (long i = 0; i < slot->data_len; i++)
+        slot->data[i] = decode_byte_to_lsb((unsigned char *)slot->carrier + i * 8);
+
+    return e_success;
+}
+
+static Status extract_matrix_block(void *ctx, PipelineSlot *slot)
+{
+    DecodeInfo *decInfo = ctx;
+
+    matrix_extract_block(&decInfo->matrix, slot->carrier, slot->data, slot->data_len);
+    return e_success;
+}
+
+static long matrix_block_len(void *ctx, long data_len)
+{
+    DecodeInfo *decInfo = ctx;
+
+    return matrix_carrier_bytes(&decInfo->matrix, data_len);
+}
+
+static Status write_secret_block(void *ctx, PipelineSlot *slot)
+{
+    DecodeInfo *decInfo = ctx;
+
+    if (fwrite(slot->data, 1, slot->data_len, decInfo->fptr_secret) != slot->data_len)
+        return e_failure;
+
+    return e_success;
+}
+
 /* =======================================================================
  *  decode_secret_data
- *  Extracts actual hidden data.
+ *  Extracts actual hidden data through the read -> extract -> write
+ *  pipeline.
  * =======================================================================*/
 Status decode_secret_data(DecodeInfo *decInfo)
 {
-    char str[decInfo->secret_data_size];
-    char buff[8];
+    PipelineStages stages = { read_stego_block, extract_secret_block, write_secret_block,
+                              decInfo, 0, NULL, &decInfo->job->arena };
 
-    for (int i = 0; i < decInfo->secret_data_size; i++)
+    if (decInfo->matrix_k > 0)
     {
-        fread(buff, 8, 1, decInfo->fptr_src_image);
-        str[i] = decode_byte_to_lsb(buff);
+        stages.embed_stage = extract_matrix_block;
+        stages.slot_data = matrix_slot_data(&decInfo->matrix);
+        stages.carrier_len = matrix_block_len;
     }
 
-    str[decInfo->secret_data_size] = '\0';
+    if (run_pipeline(&stages, decInfo->secret_data_size, decInfo->opts->pipeline_buffers) != e_success)
+    {
+        printf("❌ ERROR: Secret data could not be decoded.\n");
+        return e_failure;
+    }
+
+    return e_success;
+}
+
+/* =======================================================================
+ *  get_be32
+ *  Reads a 32-bit value stored most significant byte first.
+ * =======================================================================*/
+static uint get_be32(const unsigned char *ptr)
+{
+    return ((uint)ptr[0] << 24) | ((uint)ptr[1] << 16) | ((uint)ptr[2] << 8) | ptr[3];
+}
 
-    fwrite(str, decInfo->secret_data_size, 1, decInfo->fptr_secret);
+/* =======================================================================
+ *  decode_fec_header
+ *  Reads the FEC_HEADER_COPIES header copies and takes a bitwise
+ *  majority, so a few flipped LSBs here do not lose the image.
+ *  The message length is untrusted: a header whose codewords would
+ *  not fit in the image is rejected before anything is allocated.
+ * =======================================================================*/
+Status decode_fec_header(DecodeInfo *decInfo)
+{
+    unsigned char copies[FEC_HEADER_COPIES][FEC_HEADER_SIZE];
+    unsigned char header[FEC_HEADER_SIZE];
+    unsigned char buff[8];
+
+    fseek(decInfo->fptr_src_image, decInfo->pixel_offset, SEEK_SET);
+
+    for (int c = 0; c < FEC_HEADER_COPIES; c++)
+    {
+        for (int i = 0; i < FEC_HEADER_SIZE; i++)
+        {
+            if (fread(buff, 8, 1, decInfo->fptr_src_image) != 1)
+                return e_failure;
+            copies[c][i] = decode_byte_to_lsb(buff);
+        }
+    }
 
+    for (int i = 0; i < FEC_HEADER_SIZE; i++)
+    {
+        header[i] = 0;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            int votes = 0;
+            for (int c = 0; c < FEC_HEADER_COPIES; c++)
+                votes += (copies[c][i] >> bit) & 1;
+            if (2 * votes > FEC_HEADER_COPIES)
+                header[i] |= 1 << bit;
+        }
+    }
+
+    if (memcmp(header, FEC_MAGIC_STRING, 2) != 0
+        || header[2] < FEC_MIN_PARITY || header[2] > FEC_MAX_PARITY)
+        return e_failure;
+
+    decInfo->fec_parity = header[2];
+    decInfo->fec_msg_len = get_be32(header + 3);
+
+    long block_len = fec_codeword_count(decInfo->fec_msg_len, decInfo->fec_parity) * FEC_CODEWORD_LEN;
+    if ((FEC_HEADER_SIZE * FEC_HEADER_COPIES + block_len) * 8 > decInfo->pixel_bytes)
+    {
+        printf("❌ ERROR: FEC header claims %ld bytes, more than the image holds.\n", decInfo->fec_msg_len);
+        return e_failure;
+    }
+
+    printf("🛡️  FEC protected image: %d parity symbols per codeword.\n", decInfo->fec_parity);
+    return e_success;
+}
+
+/* =======================================================================
+ *  decode_fec_payload
+ *  Extracts the interleaved codewords through the decode pipeline,
+ *  corrects them, then unpacks extn size, extn, size and data.
+ * =======================================================================*/
+Status decode_fec_payload(DecodeInfo *decInfo)
+{
+    long msg_len = decInfo->fec_msg_len;
+    long codewords = fec_codeword_count(msg_len, decInfo->fec_parity);
+    long block_len = codewords * FEC_CODEWORD_LEN;
+    Status status = e_failure;
+
+    if (msg_len < 8 || msg_len > block_len)
+        return e_failure;
+
+    /* One spare byte: fmemopen in write mode keeps a trailing NUL */
+    unsigned char *block = arena_alloc(&decInfo->job->arena, block_len + 1);
+    unsigned char *syndromes = arena_alloc(&decInfo->job->arena, fec_scratch_len(codewords, decInfo->fec_parity));
+    if (block == NULL || syndromes == NULL)
+        return e_failure;
+
+    decInfo->fptr_secret = fmemopen(block, block_len + 1, "wb");
+    decInfo->job->uncounted_streams++;
+    decInfo->secret_data_size = block_len;
+
+    if (decInfo->fptr_secret == NULL || decode_secret_data(decInfo) != e_success)
+    {
+        if (decInfo->fptr_secret)
+            fclose(decInfo->fptr_secret);
+        decInfo->fptr_secret = NULL;
+        return e_failure;
+    }
+    fclose(decInfo->fptr_secret);
+    decInfo->fptr_secret = NULL;
+
+    Status corrected = fec_decode(block, codewords, decInfo->fec_parity, &decInfo->fec_corrected, syndromes);
+    printf("🛡️  FEC corrected %ld symbol error(s) in %ld codeword(s).\n", decInfo->fec_corrected, codewords);
+
+    unsigned char *msg = arena_alloc(&decInfo->job->arena, msg_len);
+    if (corrected != e_success)
+        printf("❌ ERROR: Too many errors, payload is not recoverable.\n");
+    else if (msg != NULL)
+    {
+        fec_deinterleave(block, codewords, decInfo->fec_parity, msg, msg_len);
+
+        long extn_size = get_be32(msg);
+        long size = (extn_size <= MAX_EXTN_SIZE && 8 + extn_size <= msg_len) ? get_be32(msg + 4 + extn_size) : -1;
+
+        if (size >= 0 && 8 + extn_size + size == msg_len)
+        {
+            char extn[MAX_EXTN_SIZE + 1];
+            memcpy(extn, msg + 4, extn_size);
+            extn[extn_size] = '\0';
+
+            decInfo->extn_size = extn_size;
+            decInfo->secret_data_size = size;
+            append_extn(decInfo, extn);
+            printf("📄 Final Output Filename : %s\n", decInfo->secret_fname);
+
+            decInfo->fptr_secret = job_fopen(decInfo->job, e_job_secret, decInfo->secret_fname, "w");
+            if (decInfo->fptr_secret == NULL)
+            {
+                perror("fopen");
+                printf("❌ ERROR: Unable to create file: %s\n", decInfo->secret_fname);
+            }
+            else if (fwrite(msg + 8 + extn_size, 1, size, decInfo->fptr_secret) == size)
+                status = e_success;
+        }
+        else
+            printf("❌ ERROR: Corrupt FEC payload layout.\n");
+    }
+
+    return status;
+}
+
+/* =======================================================================
+ *  finish_decoding
+ *  Flushes the decoded file after a successful decoding; the job
+ *  streams stay open for the next job to reopen (a PNG pixel stream
+ *  is closed).
+ * =======================================================================*/
+static Status finish_decoding(DecodeInfo *decInfo)
+{
+    if (decInfo->is_png)
+    {
+        fclose(decInfo->fptr_src_image);
+        decInfo->fptr_src_image = NULL;
+    }
+
+    if (fflush(decInfo->fptr_secret) != 0)
+    {
+        printf("❌ ERROR: Unable to write %s\n", decInfo->secret_fname);
+        return e_failure;
+    }
+
+    printf("\n🎉 SECRET DATA DECODED SUCCESSFULLY!\n\n");
     return e_success;
 }
 
@@ -218,11 +491,14 @@ Status do_decoding(DecodeInfo *decInfo)
 {
     printf("\n🚀 ===============  DECODING STARTED  ================ 🚀\n");
 
+    decInfo->matrix_k = 0;
+
     if (file_open(decInfo) == e_success)
     {
         printf("📁 File opened successfully.\n");
 
-        if (decode_magic_string(decInfo->fptr_src_image) == e_success)
+        if (decode_magic_string(decInfo->fptr_src_image, decInfo->pixel_offset) == e_success
+            || decode_matrix_header(decInfo) == e_success)
         {
             printf("🔑 Magic string verified.\n");
 
@@ -239,15 +515,23 @@ Status do_decoding(DecodeInfo *decInfo)
                         printf("📦 Secret data size decoded.\n");
 
                         if (decode_secret_data(decInfo) == e_success)
-                        {
-                            printf("\n🎉 SECRET DATA DECODED SUCCESSFULLY!\n\n");
-                            free(decInfo->secret_fname);
-                            return e_success;
-                        }
+                            return finish_decoding(decInfo);
                     }
                 }
             }
         }
+        else if (decode_fec_header(decInfo) == e_success)
+        {
+            if (decode_fec_payload(decInfo) == e_success)
+                return finish_decoding(decInfo);
+        }
+    }
+
+    /* A PNG pixel stream is not a job stream, nothing else closes it */
+    if (decInfo->is_png && decInfo->fptr_src_image)
+    {
+        fclose(decInfo->fptr_src_image);
+        decInfo->fptr_src_image = NULL;
     }
 
     printf("❌ Decoding Failed.\n");
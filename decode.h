@@ -6,18 +6,45 @@
 #include "encode.h"
 #include "common.h"
 #include "types.h"
+#include "options.h"
+#include "pipeline.h"
+#include "fec.h"
+#include "matrix.h"
+#include "job.h"
 
 typedef struct _DecodeInfo{
     /* SORCE IMAGE INFO */
     FILE *fptr_src_image;
     char *src_fname;
 
+    /* PNG stego images are read as pixel streams: pixels at offset 0 */
+    int is_png;
+    uint pixel_offset;
+
+    /* Pixel bytes the image holds after pixel_offset */
+    long pixel_bytes;
+
     /* DATA FILE */
     FILE *fptr_secret;
     char *secret_fname;
 
     int extn_size;
     int secret_data_size;
+
+    /* FEC protected images */
+    int fec_parity;
+    long fec_msg_len;
+    long fec_corrected;
+
+    /* Matrix embedded images, matrix_k = 0 for plain LSB */
+    int matrix_k;
+    MatrixCode matrix;
+
+    /* Command line switches */
+    const StegoOptions *opts;
+
+    /* Reusable streams and arena the job runs in */
+    StegoJob *job;
 }DecodeInfo;
 
 
@@ -26,7 +53,7 @@ Status do_decoding(DecodeInfo *decInfo);
 
 Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo);
 
-Status decode_magic_string(FILE *fptr_src);
+Status decode_magic_string(FILE *fptr_src, uint pixel_offset);
 
 char decode_byte_to_lsb(unsigned char* buff);
 
@@ -40,4 +67,10 @@ Status decode_secret_data_size(DecodeInfo *decInfo);
 
 Status decode_secret_data(DecodeInfo *decInfo);
 
+Status decode_matrix_header(DecodeInfo *decInfo);
+
+Status decode_fec_header(DecodeInfo *decInfo);
+
+Status decode_fec_payload(DecodeInfo *decInfo);
+
 #endif
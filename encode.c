@@ -1,4 +1,54 @@
+#define _GNU_SOURCE
 #include "encode.h"
+#include <unistd.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+/* ---------------------------------------------------------------------
+ * put_be32
+ * Stores a 32-bit value most significant byte first.
+ * -------------------------------------------------------------------*/
+static void put_be32(unsigned char *ptr, uint value)
+{
+    for (int i = 0; i < 4; i++)
+        ptr[i] = value >> (24 - 8 * i);
+}
+
+/* ---------------------------------------------------------------------
+ * read_bmp_info
+ * Reads pixel data offset (10), width (18), height (22) and bits per
+ * pixel (28) from the BMP header, without printing anything.
+ * -------------------------------------------------------------------*/
+Status read_bmp_info(FILE *fptr_image, BmpInfo *info)
+{
+    unsigned char sign[2];
+    unsigned short bpp;
+
+    fseek(fptr_image, 0, SEEK_SET);
+    if (fread(sign, 1, 2, fptr_image) != 2 || sign[0] != 'B' || sign[1] != 'M')
+        return e_failure;
+
+    fseek(fptr_image, 10, SEEK_SET);
+    if (fread(&info->pixel_offset, sizeof(int), 1, fptr_image) != 1)
+        return e_failure;
+
+    fseek(fptr_image, 18, SEEK_SET);
+    if (fread(&info->width, sizeof(int), 1, fptr_image) != 1
+        || fread(&info->height, sizeof(int), 1, fptr_image) != 1)
+        return e_failure;
+
+    fseek(fptr_image, 28, SEEK_SET);
+    if (fread(&bpp, sizeof(bpp), 1, fptr_image) != 1)
+        return e_failure;
+
+    info->bits_per_pixel = bpp;
+    return e_success;
+}
 
 /* ---------------------------------------------------------------------
  * get_image_size_for_bmp
@@ -7,16 +57,13 @@
  * -------------------------------------------------------------------*/
 uint get_image_size_for_bmp(FILE *fptr_image)
 {
-    uint width, height;
-
-    fseek(fptr_image, 18, SEEK_SET);  // Move to width position
-    fread(&width, sizeof(int), 1, fptr_image);
-    printf("📏 Image Width  : %u\n", width);
+    BmpInfo info = { 0 };
 
-    fread(&height, sizeof(int), 1, fptr_image);
-    printf("📏 Image Height : %u\n", height);
+    read_bmp_info(fptr_image, &info);
+    printf("📏 Image Width  : %u\n", info.width);
+    printf("📏 Image Height : %u\n", info.height);
 
-    return width * height * 3;  // BMP uses 3 bytes per pixel
+    return info.width * info.height * 3;  // BMP uses 3 bytes per pixel
 }
 
 /* ---------------------------------------------------------------------
@@ -26,8 +73,16 @@ uint get_image_size_for_bmp(FILE *fptr_image)
  * -------------------------------------------------------------------*/
 Status open_files(EncodeInfo *encInfo)
 {
-    /* Open source image */
-    encInfo->fptr_src_image = fopen(encInfo->src_image_fname, "rb");
+    /* Open source image (a PNG opens as a stream of its pixels) */
+    encInfo->pixel_offset = encInfo->is_png ? 0 : 54;
+    encInfo->fptr_stego_image = NULL;
+    if (encInfo->is_png)
+    {
+        encInfo->fptr_src_image = png_open_pixels(encInfo->src_image_fname, &encInfo->png);
+        encInfo->job->uncounted_streams++;
+    }
+    else
+        encInfo->fptr_src_image = job_fopen(encInfo->job, e_job_src, encInfo->src_image_fname, "rb");
     if (encInfo->fptr_src_image == NULL)
     {
         perror("fopen");
@@ -36,7 +91,7 @@ Status open_files(EncodeInfo *encInfo)
     }
 
     /* Open secret file */
-    encInfo->fptr_secret = fopen(encInfo->secret_fname, "rb");
+    encInfo->fptr_secret = job_fopen(encInfo->job, e_job_secret, encInfo->secret_fname, "rb");
     if (encInfo->fptr_secret == NULL)
     {
         perror("fopen");
@@ -45,7 +100,14 @@ Status open_files(EncodeInfo *encInfo)
     }
 
     /* Open output stego image */
-    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "wb");
+    if (encInfo->is_png)
+    {
+        encInfo->fptr_stego_image = png_create_pixels(encInfo->stego_image_fname, encInfo->src_image_fname,
+                                                      encInfo->opts->png_level);
+        encInfo->job->uncounted_streams++;
+    }
+    else
+        encInfo->fptr_stego_image = job_fopen(encInfo->job, e_job_stego, encInfo->stego_image_fname, "wb");
     if (encInfo->fptr_stego_image == NULL)
     {
         perror("fopen");
@@ -67,38 +129,84 @@ OperationType check_operation_type(char *argv[])
         return e_encode;
     else if (strcmp(argv[1], "-d") == 0)
         return e_decode;
+    else if (strcmp(argv[1], "-m") == 0)
+        return e_encode_bulk;
+    else if (strcmp(argv[1], "-u") == 0)
+        return e_update;
+    else if (strcmp(argv[1], "-a") == 0)
+        return e_analyze;
+    else if (strcmp(argv[1], "-i") == 0)
+        return e_index;
+    else if (strcmp(argv[1], "-v") == 0)
+        return e_video_encode;
+    else if (strcmp(argv[1], "-V") == 0)
+        return e_video_decode;
+    else if (strcmp(argv[1], "-B") == 0)
+        return e_batch;
 
     printf("⚠️  Usage:\n");
     printf("   ➤ Encoding: ./a.out -e <image.bmp> <secret.txt> <output.bmp>\n");
     printf("   ➤ Decoding: ./a.out -d <image.bmp>\n");
+    printf("   ➤ Fan-out : ./a.out -m <image.bmp> <secret1> <output1.bmp> [<secret2> <output2.bmp> ...]\n");
+    printf("   ➤ Update  : ./a.out -u <stego.bmp> <new_secret.txt>\n");
+    printf("   ➤ Analyze : ./a.out -a <image1.bmp> [image2.bmp ...]\n");
+    printf("   ➤ Index   : ./a.out -i <cover_dir> <covers.idx>\n");
+    printf("   ➤ Batch   : ./a.out -B <jobs.txt>\n");
+    printf("   ➤ Video   : ./a.out -v <in.y4m|-> <secret.txt> [out.y4m|-]  /  -V <stego.y4m|-> [output]\n");
     return e_unsupported;
 }
 
+/* ---------------------------------------------------------------------
+ * check_secret_extn
+ * Shared by -e, -m and -u: an extension longer than MAX_EXTN_SIZE
+ * would be embedded but rejected by decode_extn.
+ * -------------------------------------------------------------------*/
+Status check_secret_extn(const char *secret_fname)
+{
+    const char *extn = strrchr(secret_fname, '.');
+
+    if (extn == NULL)
+    {
+        printf("❌ ERROR: Secret file must include extension (e.g., file.txt): %s\n", secret_fname);
+        return e_failure;
+    }
+
+    if (strlen(extn) > MAX_EXTN_SIZE)
+    {
+        printf("❌ ERROR: Secret file extension \"%s\" is longer than %d characters\n", extn, MAX_EXTN_SIZE);
+        return e_failure;
+    }
+
+    return e_success;
+}
+
 /* ---------------------------------------------------------------------
  * read_and_validate_encode_args
- * Validates source BMP filename, secret filename, and output BMP
- * Extracts secret file extension.
+ * Validates source BMP / PNG filename, secret filename, and output
+ * image (same format as the source). Extracts secret file extension.
  * -------------------------------------------------------------------*/
 Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
 {
-    /* Validate BMP input file */
-    if (!strstr(argv[2], ".bmp"))
+    /* Validate BMP / PNG input file */
+    encInfo->is_png = is_png_name(argv[2]);
+    const char *suffix = encInfo->is_png ? ".png" : ".bmp";
+
+    if (!strcasestr(argv[2], suffix))
     {
-        printf("❌ ERROR: Source image must be \".bmp\"\n");
+        printf("❌ ERROR: Source image must be \".bmp\" or \".png\"\n");
         return e_failure;
     }
 
     /* Validate secret file extension */
-    if (!strchr(argv[3], '.'))
+    if (check_secret_extn(argv[3]) != e_success)
     {
-        printf("❌ ERROR: Secret file must include extension (e.g., file.txt)\n");
         return e_failure;
     }
 
     int len = strlen(argv[2]);
-    if (len < 4 || strcmp(argv[2] + len - 4, ".bmp") != 0)
+    if (len < 4 || strcasecmp(argv[2] + len - 4, suffix) != 0)
     {
-        printf("❌ ERROR: Invalid output \".bmp\" file\n");
+        printf("❌ ERROR: Invalid output \"%s\" file\n", suffix);
         printf("🗃️  %s\n",argv[2]);
         return e_failure;
     }
@@ -109,19 +217,19 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
 
     encInfo->secret_fname = argv[3];
 
-    /* Validate output stego BMP */
+    /* Validate output stego image */
     if (argv[4] != NULL)
     {
-        if (!strstr(argv[4], ".bmp"))
+        if (!strcasestr(argv[4], suffix))
         {
-            printf("❌ ERROR: Output file must be \".bmp\"\n");
+            printf("❌ ERROR: Output file must be \"%s\"\n", suffix);
             return e_failure;
         }
 
         int len = strlen(argv[4]);
-        if (len < 4 || strcmp(argv[4] + len - 4, ".bmp") != 0)
+        if (len < 4 || strcasecmp(argv[4] + len - 4, suffix) != 0)
         {
-            printf("❌ ERROR: Invalid output \".bmp\" file\n");
+            printf("❌ ERROR: Invalid output \"%s\" file\n", suffix);
             printf("🗃️  %s\n",argv[4]);
             return e_failure;
         }
@@ -131,8 +239,8 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     }
     else
     {
-        encInfo->stego_image_fname = "stego.bmp";
-        printf("ℹ️  Output file not given — using default: stego.bmp\n");
+        encInfo->stego_image_fname = encInfo->is_png ? "stego.png" : "stego.bmp";
+        printf("ℹ️  Output file not given — using default: %s\n", encInfo->stego_image_fname);
     }
 
     /* Store source filename */
@@ -160,15 +268,18 @@ uint get_file_size(FILE *fptr)
  * -------------------------------------------------------------------*/
 Status check_capacity(EncodeInfo *encInfo)
 {
-    encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
+    if (encInfo->is_png)
+    {
+        printf("📏 Image Width  : %u\n", encInfo->png.width);
+        printf("📏 Image Height : %u\n", encInfo->png.height);
+        encInfo->image_capacity = encInfo->png.pixel_bytes;
+    }
+    else
+        encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
     encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
 
-    long required_capacity =
-        (strlen(MAGIC_STRING)
-        + strlen(encInfo->extn_secret_file)
-        + strlen(encInfo->extn_secret_file)
-        + sizeof(encInfo->size_secret_file)
-        + encInfo->size_secret_file) * 8;
+    long required_capacity = get_required_capacity(strlen(encInfo->extn_secret_file),
+                                                   encInfo->size_secret_file);
 
     if (encInfo->image_capacity > required_capacity)
     {
@@ -207,6 +318,144 @@ Status encode_byte_to_lsb(char data, char *image_buffer)
     return e_success;
 }
 
+/*
+ * Tables for encode_block_to_lsb: lsb_spread[d] holds the 8 bits of d
+ * (MSB first) in the LSBs of 8 bytes, channel_mask[n - 1][phase][c]
+ * selects the LSBs of the bytes that belong to channel c of an n channel
+ * pixel when the first byte is channel "phase".
+ */
+static uint64_t lsb_spread[256];
+static uint64_t channel_mask[METRICS_MAX_CHANNELS][METRICS_MAX_CHANNELS][METRICS_MAX_CHANNELS];
+static pthread_once_t lsb_tables_once = PTHREAD_ONCE_INIT;
+
+static void init_lsb_tables(void)
+{
+    unsigned char bytes[8];
+
+    for (int d = 0; d < 256; d++)
+    {
+        for (int i = 0; i < 8; i++)
+            bytes[i] = (d >> (7 - i)) & 1;
+        memcpy(&lsb_spread[d], bytes, 8);
+    }
+
+    for (int n = 1; n <= METRICS_MAX_CHANNELS; n++)
+    {
+        for (int phase = 0; phase < n; phase++)
+        {
+            for (int c = 0; c < n; c++)
+            {
+                for (int i = 0; i < 8; i++)
+                    bytes[i] = ((phase + i) % n == c);
+                memcpy(&channel_mask[n - 1][phase][c], bytes, 8);
+            }
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * encode_block_to_lsb
+ * Encodes size bytes into size * 8 image bytes, 8 image bytes per
+ * 64-bit word. image_pos is the offset of image_buffer in the pixel
+ * array (for the channel). With metrics, the changed LSBs of each word
+ * (old ^ new) are counted per channel and direction while still in
+ * registers; a word that reaches the row padding is counted byte by
+ * byte, and the channel order restarts on the next row.
+ * -------------------------------------------------------------------*/
+Status encode_block_to_lsb(const char *data, long size, char *image_buffer, long image_pos, StegoMetrics *metrics)
+{
+    const uint64_t lsbs = 0x0101010101010101ULL;
+    unsigned long long up[METRICS_MAX_CHANNELS] = { 0 }, down[METRICS_MAX_CHANNELS] = { 0 }, padding = 0;
+    long col = metrics ? image_pos % metrics->row_stride : 0;
+    uint64_t word;
+
+    pthread_once(&lsb_tables_once, init_lsb_tables);
+
+    for (long i = 0; i < size; i++)
+    {
+        uint64_t bits = lsb_spread[(unsigned char)data[i]];
+
+        memcpy(&word, image_buffer + i * 8, 8);
+        uint64_t stego = (word & ~lsbs) | bits;
+        memcpy(image_buffer + i * 8, &stego, 8);
+
+        if (metrics && col + 8 <= metrics->row_bytes)
+        {
+            uint64_t diff = word ^ stego;
+            int n = metrics->channels, phase = col % n;
+
+            for (int c = 0; c < n; c++)
+            {
+                up[c] += __builtin_popcountll(diff & bits & channel_mask[n - 1][phase][c]);
+                down[c] += __builtin_popcountll(diff & ~bits & channel_mask[n - 1][phase][c]);
+            }
+        }
+        else if (metrics)
+        {
+            const unsigned char *before = (const unsigned char *)&word, *after = (const unsigned char *)&stego;
+
+            for (int j = 0; j < 8; j++)
+            {
+                int c = metrics_channel(metrics, col + j);
+
+                if (before[j] == after[j])
+                    continue;
+                if (c < 0)
+                    padding++;
+                else if (after[j] & 1)
+                    up[c]++;
+                else
+                    down[c]++;
+            }
+        }
+
+        if (metrics)
+            col = (col + 8) % metrics->row_stride;
+    }
+
+    if (metrics)
+    {
+        for (int c = 0; c < metrics->channels; c++)
+        {
+            metrics->changes[c][0] += up[c];
+            metrics->changes[c][1] += down[c];
+            metrics->changed_bytes += up[c] + down[c];
+        }
+        metrics->padding_bytes += padding;
+    }
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * encode_block_to_image
+ * Reads the image bytes for size data bytes from the source, encodes
+ * them and writes them to the stego image.
+ * -------------------------------------------------------------------*/
+static Status encode_block_to_image(EncodeInfo *encInfo, const char *data, long size)
+{
+    char buff[64 * 8];
+
+    while (size > 0)
+    {
+        long n = size < 64 ? size : 64;
+        long image_pos = ftell(encInfo->fptr_src_image) - encInfo->pixel_offset;
+
+        if (fread(buff, 8, n, encInfo->fptr_src_image) != n)
+            return e_failure;
+
+        encode_block_to_lsb(data, n, buff, image_pos, encInfo->metrics);
+
+        if (fwrite(buff, 8, n, encInfo->fptr_stego_image) != n)
+            return e_failure;
+
+        data += n;
+        size -= n;
+    }
+
+    return e_success;
+}
+
 /* ---------------------------------------------------------------------
  * encode_data_to_image
  * Encodes byte array (string) into the BMP image pixel data.
@@ -231,10 +480,8 @@ Status encode_data_to_image(char *data, int size, FILE *fptr_src_image, FILE *fp
  * -------------------------------------------------------------------*/
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
 {
-    encode_data_to_image((char *)magic_string,
-                         strlen(magic_string),
-                         encInfo->fptr_src_image,
-                         encInfo->fptr_stego_image);
+    if (encode_block_to_image(encInfo, magic_string, strlen(magic_string)) != e_success)
+        return e_failure;
 
     printf("✨ Magic string encoded successfully.\n");
     return e_success;
@@ -252,16 +499,47 @@ Status encode_size_to_lsb(long data, char *buff)
     return e_success;
 }
 
+/* ---------------------------------------------------------------------
+ * encode_matrix_code
+ * With --matrix=K: stores k after the magic string and checks that the
+ * Hamming code blocks of the data fit in the image.
+ * -------------------------------------------------------------------*/
+Status encode_matrix_code(EncodeInfo *encInfo)
+{
+    char k = encInfo->opts->matrix_k;
+
+    if (k == 0)
+        return e_success;
+
+    matrix_init(&encInfo->matrix, k);
+
+    long required = (strlen(MATRIX_MAGIC_STRING) + 1 + strlen(encInfo->extn_secret_file)) * 8 + 32 + 32
+                    + matrix_carrier_bytes(&encInfo->matrix, encInfo->size_secret_file);
+    if (required > encInfo->image_capacity)
+    {
+        printf("❌ ERROR: Image does NOT have enough capacity for --matrix=%d!\n", k);
+        return e_failure;
+    }
+
+    if (encode_block_to_image(encInfo, &k, 1) != e_success)
+        return e_failure;
+
+    printf("🧮 Matrix embedding: %d bits per %d image bytes.\n", k, encInfo->matrix.n);
+    return e_success;
+}
+
 /* ---------------------------------------------------------------------
  * encode_secret_file_extn_size
  * Encodes size of file extension (e.g., 4 for ".txt")
  * -------------------------------------------------------------------*/
 Status encode_secret_file_extn_size(long file_size, EncodeInfo *encInfo)
 {
-    char buff[32];
-    fread(buff, 32, 1, encInfo->fptr_src_image);
-    encode_size_to_lsb(file_size, buff);
-    fwrite(buff, 32, 1, encInfo->fptr_stego_image);
+    /* 32 bits MSB first, same layout as encode_size_to_lsb */
+    char size[4];
+    put_be32((unsigned char *)size, file_size);
+
+    if (encode_block_to_image(encInfo, size, 4) != e_success)
+        return e_failure;
 
     printf("📏 File extension size encoded.\n");
     return e_success;
@@ -273,10 +551,11 @@ Status encode_secret_file_extn_size(long file_size, EncodeInfo *encInfo)
  * -------------------------------------------------------------------*/
 Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
 {
-    char buff[32];
-    fread(buff, 32, 1, encInfo->fptr_src_image);
-    encode_size_to_lsb(file_size, buff);
-    fwrite(buff, 32, 1, encInfo->fptr_stego_image);
+    char size[4];
+    put_be32((unsigned char *)size, file_size);
+
+    if (encode_block_to_image(encInfo, size, 4) != e_success)
+        return e_failure;
 
     printf("📦 Secret file size encoded.\n");
     return e_success;
@@ -288,38 +567,86 @@ Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
  * -------------------------------------------------------------------*/
 Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo)
 {
-    char buff[8];
-
-    for (int i = 0; i < strlen(file_extn); i++)
-    {
-        fread(buff, 8, 1, encInfo->fptr_src_image);
-        encode_byte_to_lsb(file_extn[i], buff);
-        fwrite(buff, 8, 1, encInfo->fptr_stego_image);
-    }
+    if (encode_block_to_image(encInfo, file_extn, strlen(file_extn)) != e_success)
+        return e_failure;
 
     printf("📝 File extension encoded.\n");
     return e_success;
 }
 
+/* ---------------------------------------------------------------------
+ * Pipeline stages for encode_secret_file_data
+ * read : next block of secret bytes + the image bytes that hide them
+ * embed: LSB encode the block (or Hamming code it with --matrix)
+ * write: block of stego image bytes
+ * -------------------------------------------------------------------*/
+static Status read_secret_block(void *ctx, PipelineSlot *slot)
+{
+    EncodeInfo *encInfo = ctx;
+
+    slot->carrier_pos = ftell(encInfo->fptr_src_image) - encInfo->pixel_offset;
+    if (fread(slot->data, 1, slot->data_len, encInfo->fptr_secret) != slot->data_len
+        || fread(slot->carrier, 1, slot->carrier_len, encInfo->fptr_src_image) != slot->carrier_len)
+        return e_failure;
+
+    return e_success;
+}
+
+static Status embed_secret_block(void *ctx, PipelineSlot *slot)
+{
+    EncodeInfo *encInfo = ctx;
+
+    return encode_block_to_lsb(slot->data, slot->data_len, slot->carrier, slot->carrier_pos, encInfo->metrics);
+}
+
+static Status embed_matrix_block(void *ctx, PipelineSlot *slot)
+{
+    EncodeInfo *encInfo = ctx;
+
+    matrix_embed_block(&encInfo->matrix, slot->data, slot->data_len, slot->carrier, slot->carrier_pos, encInfo->metrics);
+    return e_success;
+}
+
+static long matrix_block_len(void *ctx, long data_len)
+{
+    EncodeInfo *encInfo = ctx;
+
+    return matrix_carrier_bytes(&encInfo->matrix, data_len);
+}
+
+static Status write_stego_block(void *ctx, PipelineSlot *slot)
+{
+    EncodeInfo *encInfo = ctx;
+
+    if (fwrite(slot->carrier, 1, slot->carrier_len, encInfo->fptr_stego_image) != slot->carrier_len)
+        return e_failure;
+
+    return e_success;
+}
+
 /* ---------------------------------------------------------------------
  * encode_secret_file_data
- * Stores all secret file bytes into the image.
+ * Stores all secret file bytes into the image, streaming through
+ * the read -> embed -> write pipeline.
  * -------------------------------------------------------------------*/
 Status encode_secret_file_data(EncodeInfo *encInfo)
 {
-    long size = encInfo->size_secret_file;
-    char buff[size];
+    PipelineStages stages = { read_secret_block, embed_secret_block, write_stego_block,
+                              encInfo, 0, NULL, &encInfo->job->arena };
 
-    rewind(encInfo->fptr_secret);
-    fread(buff, size, 1, encInfo->fptr_secret);
+    if (encInfo->opts->matrix_k > 0)
+    {
+        stages.embed_stage = embed_matrix_block;
+        stages.slot_data = matrix_slot_data(&encInfo->matrix);
+        stages.carrier_len = matrix_block_len;
+    }
 
-    char data[8];
+    rewind(encInfo->fptr_secret);
 
-    for (int i = 0; i < size; i++)
+    if (run_pipeline(&stages, encInfo->size_secret_file, encInfo->opts->pipeline_buffers) != e_success)
     {
-        fread(data, 8, 1, encInfo->fptr_src_image);
-        encode_byte_to_lsb(buff[i], data);
-        fwrite(data, 8, 1, encInfo->fptr_stego_image);
+        printf("❌ ERROR: Secret data could not be encoded.\n");
+        return e_failure;
     }
 
     printf("🔐 Secret data encoded.\n");
@@ -331,16 +658,255 @@ Status encode_secret_file_data(EncodeInfo *encInfo)
  * -------------------------------------------------------------------*/
 Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest)
 {
-    char ch;
+    char buff[BUFSIZ];
+    size_t n;
 
     printf("📥 Copying remaining image data...\n");
 
-    while (fread(&ch, 1, 1, fptr_src) > 0)
-        fwrite(&ch, 1, 1, fptr_dest);
+    while ((n = fread(buff, 1, sizeof(buff), fptr_src)) > 0)
+        if (fwrite(buff, 1, n, fptr_dest) != n)
+            return e_failure;
 
     return e_success;
 }
 
+/* ---------------------------------------------------------------------
+ * clone_src_image
+ * Makes the stego file a full copy of the source before any stage
+ * runs, so the stages only overwrite the header + payload region.
+ * Tries a reflink (FICLONE), then copy_file_range, then pread/pwrite.
+ * -------------------------------------------------------------------*/
+Status clone_src_image(FILE *fptr_src, FILE *fptr_dest)
+{
+    int src_fd = fileno(fptr_src);
+    int dest_fd = fileno(fptr_dest);
+    struct stat st;
+
+    fflush(fptr_dest);
+    if (fstat(src_fd, &st) != 0)
+    {
+        perror("fstat");
+        return e_failure;
+    }
+
+#ifdef FICLONE
+    if (ioctl(dest_fd, FICLONE, src_fd) == 0)
+    {
+        printf("🧬 Source image cloned (reflink).\n");
+        return e_success;
+    }
+#endif
+
+    off_t off_in = 0, off_out = 0;
+
+#ifdef __linux__
+    while (off_in < st.st_size)
+    {
+        ssize_t n = copy_file_range(src_fd, &off_in, dest_fd, &off_out, st.st_size - off_in, 0);
+        if (n <= 0)
+            break;
+    }
+
+    if (off_in == st.st_size)
+    {
+        printf("🧬 Source image copied in kernel (copy_file_range).\n");
+        return e_success;
+    }
+#endif
+
+    /* Buffered copy of whatever is left */
+    char buff[1 << 16];
+    while (off_in < st.st_size)
+    {
+        ssize_t n = pread(src_fd, buff, sizeof(buff), off_in);
+        if (n <= 0 || pwrite(dest_fd, buff, n, off_out) != n)
+        {
+            perror("pwrite");
+            return e_failure;
+        }
+        off_in += n;
+        off_out += n;
+    }
+
+    printf("🧬 Source image copied (buffered).\n");
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * encode_fec_payload
+ * Layout: FEC header (magic, parity, message length) x FEC_HEADER_COPIES,
+ * then the interleaved RS codewords of the message
+ * [extn size (4)] [extn] [file size (4)] [data].
+ * The codewords are streamed through the same pipeline as plain data.
+ * -------------------------------------------------------------------*/
+Status encode_fec_payload(EncodeInfo *encInfo)
+{
+    int nsym = encInfo->opts->fec_parity;
+    long extn_size = strlen(encInfo->extn_secret_file);
+    long size = encInfo->size_secret_file;
+    long msg_len = 4 + extn_size + 4 + size;
+    long codewords = fec_codeword_count(msg_len, nsym);
+    long block_len = codewords * FEC_CODEWORD_LEN;
+    Status status = e_failure;
+
+    if ((FEC_HEADER_SIZE * FEC_HEADER_COPIES + block_len) * 8 >= encInfo->image_capacity)
+    {
+        printf("❌ ERROR: Image does NOT have enough capacity for FEC payload!\n");
+        return e_failure;
+    }
+
+    unsigned char *msg = arena_alloc(&encInfo->job->arena, msg_len);
+    unsigned char *block = arena_alloc(&encInfo->job->arena, block_len);
+    unsigned char *scratch = arena_alloc(&encInfo->job->arena, fec_scratch_len(codewords, nsym));
+    unsigned char header[FEC_HEADER_SIZE];
+
+    if (msg && block && scratch)
+    {
+        put_be32(msg, extn_size);
+        memcpy(msg + 4, encInfo->extn_secret_file, extn_size);
+        put_be32(msg + 4 + extn_size, size);
+
+        rewind(encInfo->fptr_secret);
+        if (fread(msg + 8 + extn_size, 1, size, encInfo->fptr_secret) == size
+            && fec_encode(msg, msg_len, nsym, block, scratch) == e_success)
+        {
+            memcpy(header, FEC_MAGIC_STRING, 2);
+            header[2] = nsym;
+            put_be32(header + 3, msg_len);
+
+            int copies = 0;
+            while (copies < FEC_HEADER_COPIES
+                   && encode_block_to_image(encInfo, (char *)header, FEC_HEADER_SIZE) == e_success)
+                copies++;
+
+            /* Stream the codewords as if they were the secret file */
+            FILE *fptr_secret = encInfo->fptr_secret;
+            encInfo->fptr_secret = copies == FEC_HEADER_COPIES ? fmemopen(block, block_len, "rb") : NULL;
+            encInfo->job->uncounted_streams++;
+            encInfo->size_secret_file = block_len;
+
+            if (encInfo->fptr_secret)
+            {
+                status = encode_secret_file_data(encInfo);
+                fclose(encInfo->fptr_secret);
+            }
+            else if (copies < FEC_HEADER_COPIES)
+                printf("❌ ERROR: FEC header could not be written.\n");
+
+            encInfo->fptr_secret = fptr_secret;
+            encInfo->size_secret_file = size;
+        }
+    }
+
+    if (status == e_success)
+        printf("🛡️  FEC payload encoded: %ld codewords, %d parity symbols each.\n", codewords, nsym);
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * prepare_stego_image
+ * BMP: clone the source and copy its header, the stages then only
+ * overwrite the payload region. PNG: nothing, the stego pixel stream
+ * is written front to back and re-encoded as a whole.
+ * -------------------------------------------------------------------*/
+static Status prepare_stego_image(EncodeInfo *encInfo)
+{
+    if (encInfo->is_png)
+    {
+        printf("🖼️  PNG carrier: %u channel(s), level %u deflate.\n",
+               encInfo->png.channels, encInfo->opts->png_level);
+        return e_success;
+    }
+
+    if (clone_src_image(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+        return copy_bmp_header(encInfo->fptr_src_image, encInfo->fptr_stego_image);
+
+    return e_failure;
+}
+
+/* ---------------------------------------------------------------------
+ * close_png_streams
+ * PNG pixel streams are not job streams: a failed job has to close
+ * them itself or they leak (once per failing job in -B mode).
+ * -------------------------------------------------------------------*/
+static void close_png_streams(EncodeInfo *encInfo)
+{
+    if (!encInfo->is_png)
+        return;
+
+    if (encInfo->fptr_src_image)
+        fclose(encInfo->fptr_src_image);
+    if (encInfo->fptr_stego_image)
+        fclose(encInfo->fptr_stego_image);
+
+    encInfo->fptr_src_image = encInfo->fptr_stego_image = NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * finish_encoding
+ * Flushes the stego image after the payload is encoded; the job
+ * streams stay open for the next job to reopen. A PNG still needs
+ * its untouched pixels, and only fclose finishes its deflate stream.
+ * -------------------------------------------------------------------*/
+static Status finish_encoding(EncodeInfo *encInfo)
+{
+    Status status = e_success;
+
+    if (encInfo->is_png)
+    {
+        if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success)
+            status = e_failure;
+
+        fclose(encInfo->fptr_src_image);
+        if (fclose(encInfo->fptr_stego_image) != 0)
+            status = e_failure;
+
+        encInfo->fptr_src_image = encInfo->fptr_stego_image = NULL;
+    }
+    else if (fflush(encInfo->fptr_stego_image) != 0)
+        status = e_failure;
+
+    if (status != e_success)
+    {
+        printf("❌ ERROR: Stego image could not be written.\n");
+        return e_failure;
+    }
+
+    printf("\n🎉 Encoding Completed Successfully!\n");
+
+    if (encInfo->metrics)
+        print_metrics(encInfo->metrics);
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * start_metrics
+ * BMP rows are padded to a multiple of 4 bytes and stored B, G, R;
+ * PNG pixel rows are not padded and stored R, G, B (, A).
+ * -------------------------------------------------------------------*/
+static void start_metrics(EncodeInfo *encInfo)
+{
+    long row_bytes, row_stride;
+    int channels = encInfo->is_png ? encInfo->png.channels : 3;
+
+    if (encInfo->is_png)
+        row_bytes = row_stride = (long)encInfo->png.width * channels;
+    else
+    {
+        BmpInfo info = { 0 };
+
+        read_bmp_info(encInfo->fptr_src_image, &info);
+        row_bytes = (long)info.width * channels;
+        row_stride = (row_bytes + 3) & ~3L;
+    }
+
+    init_metrics(&encInfo->metrics_data, encInfo->image_capacity, row_bytes, row_stride,
+                 channels, encInfo->is_png);
+    encInfo->metrics = &encInfo->metrics_data;
+}
+
 /* ---------------------------------------------------------------------
  * do_encoding
  * Master function that performs all encoding steps in order.
@@ -353,27 +919,32 @@ Status do_encoding(EncodeInfo *encInfo)
     {
         if (check_capacity(encInfo) == e_success)
         {
-            if (copy_bmp_header(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+            encInfo->metrics = NULL;
+            if (encInfo->opts->metrics)
+                start_metrics(encInfo);
+
+            if (prepare_stego_image(encInfo) == e_success)
             {
-                if (encode_magic_string(MAGIC_STRING, encInfo) == e_success)
+                if (encInfo->opts->fec_parity > 0)
                 {
-                    if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file), encInfo) == e_success)
+                    if (encode_fec_payload(encInfo) == e_success)
+                        return finish_encoding(encInfo);
+                }
+                else if (encode_magic_string(encInfo->opts->matrix_k ? MATRIX_MAGIC_STRING : MAGIC_STRING,
+                                             encInfo) == e_success)
+                {
+                    if (encode_matrix_code(encInfo) == e_success)
                     {
-                        if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) == e_success)
+                        if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file), encInfo) == e_success)
                         {
-                            if (encode_secret_file_size(encInfo->size_secret_file, encInfo) == e_success)
+                            if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) == e_success)
                             {
-                                if (encode_secret_file_data(encInfo) == e_success)
+                                if (encode_secret_file_size(encInfo->size_secret_file, encInfo) == e_success)
                                 {
-                                    if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+                                    if (encode_secret_file_data(encInfo) == e_success)
                                     {
-                                        printf("\n🎉 Encoding Completed Successfully!\n");
-
-                                        fclose(encInfo->fptr_src_image);
-                                        fclose(encInfo->fptr_stego_image);
-                                        fclose(encInfo->fptr_secret);
-
-                                        return e_success;
+                                        /* BMP: untouched tail is already in place from clone_src_image */
+                                        return finish_encoding(encInfo);
                                     }
                                 }
                             }
@@ -384,6 +955,251 @@ Status do_encoding(EncodeInfo *encInfo)
         }
     }
 
+    close_png_streams(encInfo);
     printf("❌ Encoding failed.\n");
     return e_failure;
 }
+
+/* ---------------------------------------------------------------------
+ * get_required_capacity
+ * Image bytes needed to hide a secret file (same rule as check_capacity).
+ * -------------------------------------------------------------------*/
+long get_required_capacity(long extn_size, long secret_size)
+{
+    return (strlen(MAGIC_STRING)
+            + extn_size
+            + extn_size
+            + sizeof(long)
+            + secret_size) * 8;
+}
+
+/* ---------------------------------------------------------------------
+ * get_payload_span
+ * Image bytes actually modified after the 54 byte header:
+ * magic + extn size (32) + extn + file size (32) + data.
+ * -------------------------------------------------------------------*/
+long get_payload_span(long extn_size, long secret_size)
+{
+    return (strlen(MAGIC_STRING) + extn_size + secret_size) * 8 + 32 + 32;
+}
+
+/* ---------------------------------------------------------------------
+ * encode_payload_to_buffer
+ * Same layout as the encode_* stages, but into pixel data already
+ * held in memory (pixel_buffer points right after the BMP header).
+ * -------------------------------------------------------------------*/
+Status encode_payload_to_buffer(const char *file_extn, const char *data, long size, char *pixel_buffer)
+{
+    long extn_size = strlen(file_extn);
+    char *ptr = pixel_buffer;
+
+    for (int i = 0; i < strlen(MAGIC_STRING); i++, ptr += 8)
+        encode_byte_to_lsb(MAGIC_STRING[i], ptr);
+
+    encode_size_to_lsb(extn_size, ptr);
+    ptr += 32;
+
+    for (int i = 0; i < extn_size; i++, ptr += 8)
+        encode_byte_to_lsb(file_extn[i], ptr);
+
+    encode_size_to_lsb(size, ptr);
+    ptr += 32;
+
+    for (long i = 0; i < size; i++, ptr += 8)
+        encode_byte_to_lsb(data[i], ptr);
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * read_and_validate_bulk_encode_args
+ * ./a.out -m <input.bmp> <secret1> <output1.bmp> [<secret2> <output2.bmp> ...]
+ * -------------------------------------------------------------------*/
+Status read_and_validate_bulk_encode_args(int argc, char *argv[], BulkEncodeInfo *bulkInfo)
+{
+    int len = strlen(argv[2]);
+    if (len < 4 || strcmp(argv[2] + len - 4, ".bmp") != 0)
+    {
+        printf("❌ ERROR: Source image must be \".bmp\"\n");
+        return e_failure;
+    }
+
+    if (argc < 5 || (argc - 3) % 2 != 0)
+    {
+        printf("❌ ERROR: Every secret file needs its own output \".bmp\" file\n");
+        return e_failure;
+    }
+
+    bulkInfo->src_image_fname = argv[2];
+    bulkInfo->image_template = NULL;
+    bulkInfo->job_count = (argc - 3) / 2;
+    bulkInfo->secret_fnames = malloc(bulkInfo->job_count * sizeof(char *));
+    bulkInfo->stego_fnames = malloc(bulkInfo->job_count * sizeof(char *));
+
+    if (!bulkInfo->secret_fnames || !bulkInfo->stego_fnames)
+        return e_failure;
+
+    for (int i = 0; i < bulkInfo->job_count; i++)
+    {
+        char *secret = argv[3 + 2 * i];
+        char *stego = argv[4 + 2 * i];
+
+        if (check_secret_extn(secret) != e_success)
+            return e_failure;
+
+        len = strlen(stego);
+        if (len < 4 || strcmp(stego + len - 4, ".bmp") != 0)
+        {
+            printf("❌ ERROR: Invalid output \".bmp\" file\n");
+            printf("🗃️  %s\n", stego);
+            return e_failure;
+        }
+
+        bulkInfo->secret_fnames[i] = secret;
+        bulkInfo->stego_fnames[i] = stego;
+    }
+
+    printf("📚 Fan-out jobs detected   : %d\n", bulkInfo->job_count);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * load_image_template
+ * Reads the whole source BMP into memory, once for all jobs.
+ * -------------------------------------------------------------------*/
+Status load_image_template(BulkEncodeInfo *bulkInfo)
+{
+    FILE *fptr = fopen(bulkInfo->src_image_fname, "rb");
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open %s\n", bulkInfo->src_image_fname);
+        return e_failure;
+    }
+
+    bulkInfo->image_capacity = get_image_size_for_bmp(fptr);
+    bulkInfo->image_size = get_file_size(fptr);
+    bulkInfo->image_template = malloc(bulkInfo->image_size);
+
+    if (bulkInfo->image_template == NULL || bulkInfo->image_size < 54)
+    {
+        fclose(fptr);
+        return e_failure;
+    }
+
+    rewind(fptr);
+    if (fread(bulkInfo->image_template, 1, bulkInfo->image_size, fptr) != bulkInfo->image_size)
+    {
+        fclose(fptr);
+        return e_failure;
+    }
+
+    fclose(fptr);
+    printf("🖼️  Image template loaded (%ld bytes).\n", bulkInfo->image_size);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * encode_bulk_job
+ * Embeds one secret into a scratch copy of the payload prefix, then
+ * writes header + prefix + untouched template tail (one bulk write).
+ * -------------------------------------------------------------------*/
+static Status encode_bulk_job(BulkEncodeInfo *bulkInfo, int job)
+{
+    char *secret_fname = bulkInfo->secret_fnames[job];
+    char *stego_fname = bulkInfo->stego_fnames[job];
+    char *file_extn = strrchr(secret_fname, '.');
+    Status status = e_failure;
+
+    FILE *fptr_secret = fopen(secret_fname, "rb");
+    if (fptr_secret == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open %s\n", secret_fname);
+        return e_failure;
+    }
+
+    long size = get_file_size(fptr_secret);
+    if (bulkInfo->image_capacity <= get_required_capacity(strlen(file_extn), size)
+        || 54 + get_payload_span(strlen(file_extn), size) > bulkInfo->image_size)
+    {
+        printf("❌ ERROR: Image does NOT have enough capacity for %s!\n", secret_fname);
+        fclose(fptr_secret);
+        return e_failure;
+    }
+
+    long span = get_payload_span(strlen(file_extn), size);
+    char *data = malloc(size + 1);
+    char *prefix = malloc(span);
+
+    rewind(fptr_secret);
+    if (data && prefix && fread(data, 1, size, fptr_secret) == size)
+    {
+        memcpy(prefix, bulkInfo->image_template + 54, span);
+        encode_payload_to_buffer(file_extn, data, size, prefix);
+
+        FILE *fptr_stego = fopen(stego_fname, "wb");
+        if (fptr_stego == NULL)
+        {
+            perror("fopen");
+            fprintf(stderr, "❌ ERROR: Unable to open %s\n", stego_fname);
+        }
+        else
+        {
+            long tail = bulkInfo->image_size - 54 - span;
+
+            if (fwrite(bulkInfo->image_template, 1, 54, fptr_stego) == 54
+                && fwrite(prefix, 1, span, fptr_stego) == span
+                && fwrite(bulkInfo->image_template + 54 + span, 1, tail, fptr_stego) == tail)
+                status = e_success;
+
+            if (fclose(fptr_stego) != 0)
+                status = e_failure;
+        }
+    }
+
+    free(prefix);
+    free(data);
+    fclose(fptr_secret);
+
+    if (status == e_success)
+        printf("✅ %s ➜ %s\n", secret_fname, stego_fname);
+    else
+        printf("❌ Encoding %s ➜ %s failed.\n", secret_fname, stego_fname);
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * do_bulk_encoding
+ * Loads the carrier once and produces one stego image per job.
+ * -------------------------------------------------------------------*/
+Status do_bulk_encoding(BulkEncodeInfo *bulkInfo)
+{
+    Status status = e_success;
+
+    printf("\n🚀 ========= FAN-OUT ENCODING PROCESS STARTED ========= 🚀\n");
+
+    if (load_image_template(bulkInfo) != e_success)
+    {
+        printf("❌ Encoding failed.\n");
+        return e_failure;
+    }
+
+    for (int i = 0; i < bulkInfo->job_count; i++)
+    {
+        if (encode_bulk_job(bulkInfo, i) != e_success)
+            status = e_failure;
+    }
+
+    free(bulkInfo->image_template);
+    free(bulkInfo->secret_fnames);
+    free(bulkInfo->stego_fnames);
+
+    if (status == e_success)
+        printf("\n🎉 Fan-out Encoding Completed Successfully!\n");
+    else
+        printf("❌ Some fan-out jobs failed.\n");
+
+    return status;
+}
@@ -4,8 +4,16 @@
 #include "types.h" // Contains user defined types
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include "common.h"
 #include "decode.h"
+#include "options.h"
+#include "pipeline.h"
+#include "fec.h"
+#include "metrics.h"
+#include "matrix.h"
+#include "png_stream.h"
+#include "job.h"
 #include <stdlib.h>
 
 /* 
@@ -17,7 +25,7 @@
 
 #define MAX_SECRET_BUF_SIZE 1
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8)
-#define MAX_FILE_SUFFIX 4
+#define MAX_FILE_SUFFIX (MAX_EXTN_SIZE + 1)
 
 typedef struct _EncodeInfo
 {
@@ -28,6 +36,11 @@ typedef struct _EncodeInfo
     uint bits_per_pixel;
     char image_data[MAX_IMAGE_BUF_SIZE];
 
+    /* PNG carriers are pixel streams: pixels at offset 0, not 54 */
+    int is_png;
+    PngInfo png;
+    uint pixel_offset;
+
     /* Secret File Info */
     char *secret_fname;
     FILE *fptr_secret;
@@ -39,8 +52,50 @@ typedef struct _EncodeInfo
     char *stego_image_fname;
     FILE *fptr_stego_image;
 
+    /* Command line switches */
+    const StegoOptions *opts;
+
+    /* Reusable streams and arena the job runs in */
+    StegoJob *job;
+
+    /* Distortion metrics (--metrics), NULL when off */
+    StegoMetrics *metrics;
+    StegoMetrics metrics_data;
+
+    /* Hamming code tables (--matrix=K) */
+    MatrixCode matrix;
+
 } EncodeInfo;
 
+/* Fields of the BMP header used by the tools */
+typedef struct _BmpInfo
+{
+    uint pixel_offset;
+    uint width;
+    uint height;
+    uint bits_per_pixel;
+} BmpInfo;
+
+/*
+ * Structure for fan-out encoding: one source image is
+ * loaded once and shared as a template, every job hides
+ * its own secret file into its own stego image
+ */
+typedef struct _BulkEncodeInfo
+{
+    /* Source Image template */
+    char *src_image_fname;
+    char *image_template;
+    long image_size;
+    uint image_capacity;
+
+    /* Jobs: secret file i goes into stego image i */
+    int job_count;
+    char **secret_fnames;
+    char **stego_fnames;
+
+} BulkEncodeInfo;
+
 
 /* Encoding function prototype */
 
@@ -50,6 +105,9 @@ OperationType check_operation_type(char *argv[]);
 /* Read and validate Encode args from argv */
 Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo);
 
+/* Secret file needs an extension the decoder can restore */
+Status check_secret_extn(const char *secret_fname);
+
 /* Perform the encoding */
 Status do_encoding(EncodeInfo *encInfo);
 
@@ -59,6 +117,9 @@ Status open_files(EncodeInfo *encInfo);
 /* check capacity */
 Status check_capacity(EncodeInfo *encInfo);
 
+/* Read BMP header fields */
+Status read_bmp_info(FILE *fptr_image, BmpInfo *info);
+
 /* Get image size */
 uint get_image_size_for_bmp(FILE *fptr_image);
 
@@ -80,6 +141,9 @@ Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo);
 /* Encode a size into LSB of image data array */
 Status encode_size_to_lsb(long data, char *buff);
 
+/* Encode matrix embedding parameter k (no-op without --matrix) */
+Status encode_matrix_code(EncodeInfo *encInfo);
+
 /* Encode secret file size extenstion*/
 Status encode_secret_file_extn_size(long file_extn_size, EncodeInfo *encInfo);
 
@@ -92,7 +156,34 @@ Status encode_data_to_image(char *data, int size, FILE *fptr_src_image, FILE *fp
 /* Encode a byte into LSB of image data array */
 Status encode_byte_to_lsb(char data, char *image_buffer);
 
+/* Encode size bytes into LSB of size * 8 image bytes, optionally measuring distortion */
+Status encode_block_to_lsb(const char *data, long size, char *image_buffer, long image_pos, StegoMetrics *metrics);
+
 /* Copy remaining image bytes from src to stego image after encoding */
 Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest);
 
+/* Encode secret file as Reed-Solomon protected payload (--fec=N) */
+Status encode_fec_payload(EncodeInfo *encInfo);
+
+/* Clone src image into stego image (reflink / copy_file_range / buffered) */
+Status clone_src_image(FILE *fptr_src, FILE *fptr_dest);
+
+/* Capacity (in image bytes) needed to hide a secret file */
+long get_required_capacity(long extn_size, long secret_size);
+
+/* Number of image bytes actually touched by the payload */
+long get_payload_span(long extn_size, long secret_size);
+
+/* Encode magic string, extension, size and data into an in-memory pixel buffer */
+Status encode_payload_to_buffer(const char *file_extn, const char *data, long size, char *pixel_buffer);
+
+/* Read and validate fan-out Encode args from argv */
+Status read_and_validate_bulk_encode_args(int argc, char *argv[], BulkEncodeInfo *bulkInfo);
+
+/* Load source image once into the shared template */
+Status load_image_template(BulkEncodeInfo *bulkInfo);
+
+/* Perform the fan-out encoding */
+Status do_bulk_encoding(BulkEncodeInfo *bulkInfo);
+
 #endif
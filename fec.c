@@ -0,0 +1,379 @@
+#include <string.h>
+#include <pthread.h>
+#include "fec.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FEC_X86 1
+#endif
+
+static unsigned char gf_exp[512];
+static unsigned char gf_log[256];
+static pthread_once_t gf_once = PTHREAD_ONCE_INIT;
+
+/* Region kernel picked once for this CPU */
+static void (*mul_region_kernel)(const unsigned char *lo, const unsigned char *hi,
+                                 const unsigned char *src, unsigned char *dst, long len, int add);
+
+/* ---------------------------------------------------------------------
+ * Scalar kernel: dst (^)= c * src using the 4-bit split tables
+ * -------------------------------------------------------------------*/
+static void mul_region_scalar(const unsigned char *lo, const unsigned char *hi,
+                              const unsigned char *src, unsigned char *dst, long len, int add)
+{
+    for (long i = 0; i < len; i++)
+    {
+        unsigned char p = lo[src[i] & 0x0f] ^ hi[src[i] >> 4];
+        dst[i] = add ? dst[i] ^ p : p;
+    }
+}
+
+#ifdef FEC_X86
+/* ---------------------------------------------------------------------
+ * SSSE3 / AVX2 kernels: pshufb looks up 16 (32) products at a time,
+ * low nibble in one table, high nibble in the other.
+ * -------------------------------------------------------------------*/
+__attribute__((target("ssse3")))
+static void mul_region_ssse3(const unsigned char *lo, const unsigned char *hi,
+                             const unsigned char *src, unsigned char *dst, long len, int add)
+{
+    __m128i tlo = _mm_loadu_si128((const __m128i *)lo);
+    __m128i thi = _mm_loadu_si128((const __m128i *)hi);
+    __m128i mask = _mm_set1_epi8(0x0f);
+    long i = 0;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(tlo, _mm_and_si128(x, mask)),
+                                  _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(x, 4), mask)));
+        if (add)
+            p = _mm_xor_si128(p, _mm_loadu_si128((const __m128i *)(dst + i)));
+        _mm_storeu_si128((__m128i *)(dst + i), p);
+    }
+
+    mul_region_scalar(lo, hi, src + i, dst + i, len - i, add);
+}
+
+__attribute__((target("avx2")))
+static void mul_region_avx2(const unsigned char *lo, const unsigned char *hi,
+                            const unsigned char *src, unsigned char *dst, long len, int add)
+{
+    __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)lo));
+    __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)hi));
+    __m256i mask = _mm256_set1_epi8(0x0f);
+    long i = 0;
+
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(tlo, _mm256_and_si256(x, mask)),
+                                     _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask)));
+        if (add)
+            p = _mm256_xor_si256(p, _mm256_loadu_si256((const __m256i *)(dst + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i), p);
+    }
+
+    mul_region_ssse3(lo, hi, src + i, dst + i, len - i, add);
+}
+#endif
+
+/* ---------------------------------------------------------------------
+ * gf_init
+ * Builds exp/log tables and selects the region kernel.
+ * -------------------------------------------------------------------*/
+static void gf_init(void)
+{
+    int x = 1;
+
+    for (int i = 0; i < 255; i++)
+    {
+        gf_exp[i] = x;
+        gf_log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= 0x11d;
+    }
+    for (int i = 255; i < 512; i++)
+        gf_exp[i] = gf_exp[i - 255];
+
+    mul_region_kernel = mul_region_scalar;
+#ifdef FEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        mul_region_kernel = mul_region_avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        mul_region_kernel = mul_region_ssse3;
+#endif
+}
+
+static unsigned char gf_mul(unsigned char a, unsigned char b)
+{
+    if (a == 0 || b == 0)
+        return 0;
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static unsigned char gf_div(unsigned char a, unsigned char b)
+{
+    if (a == 0)
+        return 0;
+    return gf_exp[gf_log[a] + 255 - gf_log[b]];
+}
+
+/* alpha^p for any p >= 0 */
+static unsigned char gf_pow_alpha(long p)
+{
+    return gf_exp[p % 255];
+}
+
+/* ---------------------------------------------------------------------
+ * build_split_tables
+ * lo[i] = c * i, hi[i] = c * (i << 4) for the nibble lookups.
+ * -------------------------------------------------------------------*/
+static void build_split_tables(unsigned char c, unsigned char *lo, unsigned char *hi)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        lo[i] = gf_mul(c, i);
+        hi[i] = gf_mul(c, i << 4);
+    }
+}
+
+void gf_mul_region(unsigned char c, const unsigned char *src, unsigned char *dst, long len)
+{
+    unsigned char lo[16], hi[16];
+
+    pthread_once(&gf_once, gf_init);
+    build_split_tables(c, lo, hi);
+    mul_region_kernel(lo, hi, src, dst, len, 0);
+}
+
+void gf_mul_add_region(unsigned char c, const unsigned char *src, unsigned char *dst, long len)
+{
+    unsigned char lo[16], hi[16];
+
+    pthread_once(&gf_once, gf_init);
+    build_split_tables(c, lo, hi);
+    mul_region_kernel(lo, hi, src, dst, len, 1);
+}
+
+/* ---------------------------------------------------------------------
+ * fec_codeword_count
+ * -------------------------------------------------------------------*/
+long fec_codeword_count(long msg_len, int nsym)
+{
+    long k = FEC_CODEWORD_LEN - nsym;
+    long count = (msg_len + k - 1) / k;
+
+    return count > 0 ? count : 1;
+}
+
+/* ---------------------------------------------------------------------
+ * fec_scratch_len
+ * nsym parity registers plus the feedback row when encoding,
+ * nsym syndrome rows when decoding.
+ * -------------------------------------------------------------------*/
+long fec_scratch_len(long codeword_count, int nsym)
+{
+    return (nsym + 1) * codeword_count;
+}
+
+/* ---------------------------------------------------------------------
+ * fec_encode
+ * Message rows are copied as is (row j = symbol j of every codeword),
+ * the nsym parity rows come from an LFSR run over whole rows:
+ * feedback = row ^ R0, R1..R(n-1) ^= g_i * feedback, R0 = g_n * feedback,
+ * then the registers shift by one.
+ * -------------------------------------------------------------------*/
+Status fec_encode(const unsigned char *msg, long msg_len, int nsym, unsigned char *out, unsigned char *scratch)
+{
+    long ncw = fec_codeword_count(msg_len, nsym);
+    long k = FEC_CODEWORD_LEN - nsym;
+    unsigned char gen[FEC_MAX_PARITY + 1] = { 1 };
+    unsigned char *reg[FEC_MAX_PARITY];
+
+    pthread_once(&gf_once, gf_init);
+
+    /* g(x) = (x - a^0)(x - a^1)...(x - a^(nsym-1)), highest degree first */
+    for (int i = 0; i < nsym; i++)
+    {
+        for (int j = i + 1; j > 0; j--)
+            gen[j] ^= gf_mul(gen[j - 1], gf_exp[i]);
+    }
+
+    memset(scratch, 0, nsym * ncw);
+
+    unsigned char *feedback = scratch + nsym * ncw;
+    for (int i = 0; i < nsym; i++)
+        reg[i] = scratch + i * ncw;
+
+    memset(out, 0, FEC_CODEWORD_LEN * ncw);
+    memcpy(out, msg, msg_len);
+
+    for (long j = 0; j < k; j++)
+    {
+        const unsigned char *row = out + j * ncw;
+
+        for (long c = 0; c < ncw; c++)
+            feedback[c] = row[c] ^ reg[0][c];
+
+        for (int i = 1; i < nsym; i++)
+            gf_mul_add_region(gen[i], feedback, reg[i], ncw);
+        gf_mul_region(gen[nsym], feedback, reg[0], ncw);
+
+        unsigned char *first = reg[0];
+        memmove(reg, reg + 1, (nsym - 1) * sizeof(reg[0]));
+        reg[nsym - 1] = first;
+    }
+
+    for (int i = 0; i < nsym; i++)
+        memcpy(out + (k + i) * ncw, reg[i], ncw);
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * correct_codeword
+ * Berlekamp-Massey, Chien search and Forney for one codeword whose
+ * syndromes are not all zero. Symbol j is read/written at cw[j * stride].
+ * Returns number of symbols corrected, or -1 if uncorrectable.
+ * -------------------------------------------------------------------*/
+static int correct_codeword(unsigned char *cw, long stride, const unsigned char *syn, int nsym)
+{
+    unsigned char lambda[FEC_MAX_PARITY + 1] = { 1 }, prev[FEC_MAX_PARITY + 1] = { 1 };
+    unsigned char temp[FEC_MAX_PARITY + 1], omega[FEC_MAX_PARITY];
+    int errors = 0, shift = 1;
+    unsigned char last = 1;
+
+    /* Error locator polynomial, lowest degree first */
+    for (int n = 0; n < nsym; n++)
+    {
+        unsigned char d = syn[n];
+        for (int i = 1; i <= errors; i++)
+            d ^= gf_mul(lambda[i], syn[n - i]);
+
+        if (d == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        unsigned char scale = gf_div(d, last);
+        memcpy(temp, lambda, sizeof(temp));
+        for (int i = 0; i + shift <= nsym; i++)
+            lambda[i + shift] ^= gf_mul(scale, prev[i]);
+
+        if (2 * errors <= n)
+        {
+            errors = n + 1 - errors;
+            memcpy(prev, temp, sizeof(prev));
+            last = d;
+            shift = 1;
+        }
+        else
+            shift++;
+    }
+
+    if (2 * errors > nsym)
+        return -1;
+
+    /* Error evaluator: omega = syn * lambda mod x^nsym */
+    for (int i = 0; i < nsym; i++)
+    {
+        omega[i] = 0;
+        for (int j = 0; j <= i && j <= errors; j++)
+            omega[i] ^= gf_mul(lambda[j], syn[i - j]);
+    }
+
+    int found = 0;
+    for (int j = 0; j < FEC_CODEWORD_LEN; j++)
+    {
+        /* Symbol j is the coefficient of x^(254 - j): X = a^(254 - j) */
+        int p = FEC_CODEWORD_LEN - 1 - j;
+        unsigned char x_inv = gf_pow_alpha(255 - p);
+        unsigned char value = 0, deriv = 0, eval = 0, power = 1;
+
+        for (int i = 0; i <= errors; i++)
+        {
+            value ^= gf_mul(lambda[i], power);
+            if (i & 1)
+                deriv ^= gf_mul(lambda[i], gf_pow_alpha((long)(255 - p) * (i - 1)));
+            power = gf_mul(power, x_inv);
+        }
+
+        if (value != 0)
+            continue;
+
+        power = 1;
+        for (int i = 0; i < nsym; i++)
+        {
+            eval ^= gf_mul(omega[i], power);
+            power = gf_mul(power, x_inv);
+        }
+
+        if (deriv == 0)
+            return -1;
+
+        /* Forney, first root a^0: e = X * omega(X^-1) / lambda'(X^-1) */
+        cw[j * stride] ^= gf_mul(gf_pow_alpha(p), gf_div(eval, deriv));
+        found++;
+    }
+
+    return (found == errors) ? found : -1;
+}
+
+/* ---------------------------------------------------------------------
+ * fec_decode
+ * Syndromes of all codewords are computed row by row with the region
+ * kernels (S_i ^= a^(i * (254 - j)) * row_j); only codewords with a
+ * non-zero syndrome go through the scalar correction.
+ * -------------------------------------------------------------------*/
+Status fec_decode(unsigned char *block, long codeword_count, int nsym, long *corrected, unsigned char *syndromes)
+{
+    long ncw = codeword_count;
+    unsigned char syn[FEC_MAX_PARITY];
+    Status status = e_success;
+
+    pthread_once(&gf_once, gf_init);
+    *corrected = 0;
+
+    memset(syndromes, 0, nsym * ncw);
+
+    for (long j = 0; j < FEC_CODEWORD_LEN; j++)
+    {
+        for (int i = 0; i < nsym; i++)
+            gf_mul_add_region(gf_pow_alpha((long)i * (FEC_CODEWORD_LEN - 1 - j)),
+                              block + j * ncw, syndromes + i * ncw, ncw);
+    }
+
+    for (long c = 0; c < ncw; c++)
+    {
+        int dirty = 0;
+        for (int i = 0; i < nsym; i++)
+        {
+            syn[i] = syndromes[i * ncw + c];
+            dirty |= syn[i];
+        }
+
+        if (!dirty)
+            continue;
+
+        int fixed = correct_codeword(block + c, ncw, syn, nsym);
+        if (fixed < 0)
+            status = e_failure;
+        else
+            *corrected += fixed;
+    }
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * fec_deinterleave
+ * Message rows come first in the block, so the message is its prefix.
+ * -------------------------------------------------------------------*/
+void fec_deinterleave(const unsigned char *block, long codeword_count, int nsym, unsigned char *msg, long msg_len)
+{
+    memcpy(msg, block, msg_len);
+}
@@ -0,0 +1,43 @@
+#ifndef FEC_H
+#define FEC_H
+
+#include "types.h"
+
+/*
+ * Reed-Solomon forward error correction over GF(256)
+ * (primitive polynomial 0x11d, first consecutive root alpha^0).
+ *
+ * Codewords are RS(255, 255 - nsym) and always full length; the
+ * message is zero padded to a whole number of codewords. Codewords
+ * are interleaved symbol by symbol: symbol j of codeword c sits at
+ * j * codeword_count + c. That spreads a burst of damaged carrier
+ * bytes over many codewords, and it puts one symbol of every codeword
+ * side by side, so the GF kernels run over all codewords at once.
+ */
+
+#define FEC_CODEWORD_LEN 255
+#define FEC_MIN_PARITY 2
+#define FEC_MAX_PARITY 128
+
+/* Multiply a region by a constant: dst = c * src */
+void gf_mul_region(unsigned char c, const unsigned char *src, unsigned char *dst, long len);
+
+/* Multiply-accumulate a region by a constant: dst ^= c * src */
+void gf_mul_add_region(unsigned char c, const unsigned char *src, unsigned char *dst, long len);
+
+/* Codewords needed for msg_len bytes with nsym parity symbols each */
+long fec_codeword_count(long msg_len, int nsym);
+
+/* Work buffer bytes fec_encode / fec_decode need, supplied by the caller */
+long fec_scratch_len(long codeword_count, int nsym);
+
+/* Encode msg into out (fec_codeword_count * FEC_CODEWORD_LEN bytes, interleaved) */
+Status fec_encode(const unsigned char *msg, long msg_len, int nsym, unsigned char *out, unsigned char *scratch);
+
+/* Correct an interleaved block in place; *corrected = symbol errors fixed */
+Status fec_decode(unsigned char *block, long codeword_count, int nsym, long *corrected, unsigned char *syndromes);
+
+/* Extract the message bytes from a corrected interleaved block */
+void fec_deinterleave(const unsigned char *block, long codeword_count, int nsym, unsigned char *msg, long msg_len);
+
+#endif
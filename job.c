@@ -0,0 +1,76 @@
+#include "job.h"
+
+/* ---------------------------------------------------------------------
+ * init_job
+ * -------------------------------------------------------------------*/
+void init_job(StegoJob *job)
+{
+    arena_init(&job->arena);
+    for (int i = 0; i < e_job_streams; i++)
+        job->streams[i] = NULL;
+    job->files_created = 0;
+    job->uncounted_streams = 0;
+}
+
+/* ---------------------------------------------------------------------
+ * reset_job
+ * -------------------------------------------------------------------*/
+void reset_job(StegoJob *job)
+{
+    arena_reset(&job->arena);
+}
+
+/* ---------------------------------------------------------------------
+ * job_fopen
+ * freopen closes the previous file of this stream and reuses its FILE;
+ * the stream always gets its own buffer from the context.
+ * -------------------------------------------------------------------*/
+FILE *job_fopen(StegoJob *job, JobStream stream, const char *fname, const char *mode)
+{
+    FILE *fptr;
+
+    if (job->streams[stream])
+    {
+        fptr = freopen(fname, mode, job->streams[stream]);
+    }
+    else
+    {
+        fptr = fopen(fname, mode);
+        if (fptr)
+            job->files_created++;
+    }
+
+    job->streams[stream] = fptr;
+
+    if (fptr)
+        setvbuf(fptr, job->stdio_buf[stream], _IOFBF, JOB_STDIO_BUFSIZ);
+
+    return fptr;
+}
+
+/* ---------------------------------------------------------------------
+ * job_heap_allocs
+ * -------------------------------------------------------------------*/
+unsigned long job_heap_allocs(const StegoJob *job)
+{
+    return job->files_created + job->arena.heap_allocs;
+}
+
+/* ---------------------------------------------------------------------
+ * close_job
+ * Fails if buffered output of a stream could not be written.
+ * -------------------------------------------------------------------*/
+Status close_job(StegoJob *job)
+{
+    Status status = e_success;
+
+    for (int i = 0; i < e_job_streams; i++)
+    {
+        if (job->streams[i] && fclose(job->streams[i]) != 0)
+            status = e_failure;
+        job->streams[i] = NULL;
+    }
+
+    arena_release(&job->arena);
+    return status;
+}
@@ -0,0 +1,57 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <stdio.h>
+#include "types.h"
+#include "arena.h"
+
+/* stdio buffer of each job stream */
+#define JOB_STDIO_BUFSIZ (64 * 1024)
+
+/* Longest decoded output file name (name + extension) */
+#define JOB_NAME_MAX 4096
+
+/* Streams a job opens, each keeps its FILE and buffer between jobs */
+typedef enum
+{
+    e_job_src,
+    e_job_secret,
+    e_job_stego,
+    e_job_streams
+} JobStream;
+
+/*
+ * Reusable context of one worker: the arena for per-job buffers
+ * and the job streams. A stream is reopened in place (freopen) by
+ * the next job, so after the first job of a kind nothing new is
+ * taken from the heap. heap_allocs counts the FILE objects created
+ * plus the arena's blocks. Streams opened through libc or zlib
+ * (fmemopen for FEC, PNG pixel streams) allocate where this can't
+ * see; they are only counted in uncounted_streams.
+ */
+typedef struct _StegoJob
+{
+    Arena arena;
+    FILE *streams[e_job_streams];
+    char stdio_buf[e_job_streams][JOB_STDIO_BUFSIZ];
+    unsigned long files_created;
+    unsigned long uncounted_streams;
+
+} StegoJob;
+
+/* Empty context, no streams open */
+void init_job(StegoJob *job);
+
+/* Start of a job: all arena memory is free again */
+void reset_job(StegoJob *job);
+
+/* Open fname as the given stream, reusing its FILE and buffer */
+FILE *job_fopen(StegoJob *job, JobStream stream, const char *fname, const char *mode);
+
+/* Heap allocations made through the context so far */
+unsigned long job_heap_allocs(const StegoJob *job);
+
+/* Close the streams and release the arena */
+Status close_job(StegoJob *job);
+
+#endif
@@ -0,0 +1,157 @@
+#include <string.h>
+#include <stdint.h>
+#include "matrix.h"
+
+/* ---------------------------------------------------------------------
+ * matrix_init
+ * syndrome[g][v] = XOR of (8g + j + 1) over every bit j of v, where bit
+ * (7 - j) of v is the LSB of byte 8g + j (see gather_lsbs).
+ * -------------------------------------------------------------------*/
+void matrix_init(MatrixCode *code, int k)
+{
+    code->k = k;
+    code->n = (1 << k) - 1;
+
+    for (int g = 0; g < MATRIX_GROUPS; g++)
+    {
+        for (int v = 0; v < 256; v++)
+        {
+            int s = 0;
+            for (int j = 0; j < 8; j++)
+            {
+                if (((v >> (7 - j)) & 1) && 8 * g + j < code->n)
+                    s ^= 8 * g + j + 1;
+            }
+            code->syndrome[g][v] = s;
+        }
+    }
+}
+
+long matrix_carrier_bytes(const MatrixCode *code, long size)
+{
+    long symbols = (size * 8 + code->k - 1) / code->k;
+    return symbols * code->n;
+}
+
+long matrix_slot_data(const MatrixCode *code)
+{
+    /* k bytes hold exactly 8 symbols, so slots never split a symbol */
+    return (long)code->k * MATRIX_SLOT_SYMBOLS / 8;
+}
+
+/* ---------------------------------------------------------------------
+ * gather_lsbs
+ * LSBs of 8 image bytes into one byte: bit (7 - j) = LSB of byte j.
+ * Multiplying the masked word by 0x8040201008040201 moves the bit of
+ * byte j to bit 63 - j without carries.
+ * -------------------------------------------------------------------*/
+static unsigned char gather_lsbs(const char *ptr)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    memcpy(&word, ptr, 8);
+    return ((word & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56;
+#else
+    unsigned char v = 0;
+    for (int j = 0; j < 8; j++)
+        v |= (ptr[j] & 1) << (7 - j);
+    return v;
+#endif
+}
+
+/* ---------------------------------------------------------------------
+ * block_syndrome
+ * Syndrome of the n LSBs starting at ptr: one table lookup per 8 bytes,
+ * the last partial group byte by byte (it may end the buffer).
+ * -------------------------------------------------------------------*/
+static int block_syndrome(const MatrixCode *code, const char *ptr)
+{
+    int s = 0, g = 0;
+
+    for (; 8 * g + 8 <= code->n; g++)
+        s ^= code->syndrome[g][gather_lsbs(ptr + 8 * g)];
+
+    for (int i = 8 * g; i < code->n; i++)
+        if (ptr[i] & 1)
+            s ^= i + 1;
+
+    return s;
+}
+
+/* ---------------------------------------------------------------------
+ * next_symbol
+ * Reads the next k bits (MSB first) of data, zero padded at the end.
+ * -------------------------------------------------------------------*/
+static int next_symbol(const char *data, long size, long bit, int k)
+{
+    int m = 0;
+
+    for (int i = 0; i < k; i++, bit++)
+    {
+        int b = (bit / 8 < size) ? ((unsigned char)data[bit / 8] >> (7 - bit % 8)) & 1 : 0;
+        m = (m << 1) | b;
+    }
+
+    return m;
+}
+
+/* ---------------------------------------------------------------------
+ * matrix_embed_block
+ * For each symbol m: d = syndrome ^ m, flip LSB of byte d - 1 if d != 0.
+ * -------------------------------------------------------------------*/
+long matrix_embed_block(const MatrixCode *code, const char *data, long size,
+                        char *image_buffer, long image_pos, StegoMetrics *metrics)
+{
+    long bits = size * 8, changed = 0;
+    char *ptr = image_buffer;
+
+    for (long bit = 0; bit < bits; bit += code->k, ptr += code->n)
+    {
+        int d = block_syndrome(code, ptr) ^ next_symbol(data, size, bit, code->k);
+        if (d == 0)
+            continue;
+
+        char *byte = ptr + d - 1;
+        changed++;
+
+        if (metrics)
+        {
+            int channel = metrics_channel(metrics, image_pos + (byte - image_buffer));
+
+            if (channel < 0)
+                metrics->padding_bytes++;
+            else
+            {
+                metrics->changes[channel][(*byte & 1) ? 1 : 0]++;
+                metrics->changed_bytes++;
+            }
+        }
+
+        *byte ^= 1;
+    }
+
+    return changed;
+}
+
+/* ---------------------------------------------------------------------
+ * matrix_extract_block
+ * Concatenates the syndromes of consecutive n-byte blocks.
+ * -------------------------------------------------------------------*/
+void matrix_extract_block(const MatrixCode *code, const char *image_buffer, char *data, long size)
+{
+    long bits = size * 8;
+    const char *ptr = image_buffer;
+
+    memset(data, 0, size);
+
+    for (long bit = 0; bit < bits; bit += code->k, ptr += code->n)
+    {
+        int m = block_syndrome(code, ptr);
+
+        for (int i = 0; i < code->k && bit + i < bits; i++)
+        {
+            if ((m >> (code->k - 1 - i)) & 1)
+                data[(bit + i) / 8] |= 0x80 >> ((bit + i) % 8);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "types.h"
+#include "metrics.h"
+
+/*
+ * Matrix embedding with (1, n, k) Hamming codes: k message bits are
+ * hidden in the LSBs of n = 2^k - 1 image bytes by changing at most
+ * one of them. The k bits are the syndrome of the n LSBs, i.e. the
+ * XOR of (i + 1) over every byte i whose LSB is set.
+ */
+
+#define MATRIX_MIN_K 2
+#define MATRIX_MAX_K 8
+#define MATRIX_MAX_N ((1 << MATRIX_MAX_K) - 1)
+#define MATRIX_GROUPS ((MATRIX_MAX_N + 7) / 8)
+
+/* Secret bytes per pipeline buffer in matrix mode: a multiple of k */
+#define MATRIX_SLOT_SYMBOLS 4096
+
+typedef struct _MatrixCode
+{
+    int k;
+    int n;
+
+    /* syndrome[g][v]: syndrome contribution of LSB pattern v of bytes 8g..8g+7 */
+    unsigned char syndrome[MATRIX_GROUPS][256];
+
+} MatrixCode;
+
+/* Build the syndrome tables for k */
+void matrix_init(MatrixCode *code, int k);
+
+/* Image bytes needed to hide size secret bytes */
+long matrix_carrier_bytes(const MatrixCode *code, long size);
+
+/* Secret bytes per pipeline buffer (whole k-bit symbols) */
+long matrix_slot_data(const MatrixCode *code);
+
+/* Hide size bytes in image_buffer; returns number of image bytes changed */
+long matrix_embed_block(const MatrixCode *code, const char *data, long size,
+                        char *image_buffer, long image_pos, StegoMetrics *metrics);
+
+/* Recover size bytes from image_buffer */
+void matrix_extract_block(const MatrixCode *code, const char *image_buffer, char *data, long size);
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "metrics.h"
+
+/* ---------------------------------------------------------------------
+ * init_metrics
+ * -------------------------------------------------------------------*/
+void init_metrics(StegoMetrics *metrics, unsigned long long pixel_bytes, long row_bytes, long row_stride,
+                  int channels, int rgb_order)
+{
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->pixel_bytes = pixel_bytes;
+    metrics->row_bytes = row_bytes;
+    metrics->row_stride = row_stride;
+    metrics->channels = channels;
+    metrics->rgb_order = rgb_order;
+}
+
+/* ---------------------------------------------------------------------
+ * metrics_channel
+ * The channel order restarts at every row, after the padding.
+ * -------------------------------------------------------------------*/
+int metrics_channel(const StegoMetrics *metrics, long image_pos)
+{
+    long col = image_pos % metrics->row_stride;
+
+    return col < metrics->row_bytes ? col % metrics->channels : -1;
+}
+
+/* ---------------------------------------------------------------------
+ * metrics_mse
+ * Every changed byte contributes (+-1)^2 = 1.
+ * -------------------------------------------------------------------*/
+double metrics_mse(const StegoMetrics *metrics)
+{
+    if (metrics->pixel_bytes == 0)
+        return 0.0;
+
+    return (double)metrics->changed_bytes / metrics->pixel_bytes;
+}
+
+/* ---------------------------------------------------------------------
+ * metrics_psnr
+ * -------------------------------------------------------------------*/
+double metrics_psnr(const StegoMetrics *metrics)
+{
+    double mse = metrics_mse(metrics);
+
+    if (mse == 0.0)
+        return INFINITY;
+
+    return 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+/* ---------------------------------------------------------------------
+ * print_metrics
+ * -------------------------------------------------------------------*/
+void print_metrics(const StegoMetrics *metrics)
+{
+    static const char *bgr_names[METRICS_MAX_CHANNELS] = { "Blue ", "Green", "Red  ", "Alpha" };
+    static const char *rgb_names[METRICS_MAX_CHANNELS] = { "Red  ", "Green", "Blue ", "Alpha" };
+    const char **names = metrics->rgb_order ? rgb_names : bgr_names;
+
+    printf("\n📊 ================ DISTORTION REPORT ================ 📊\n");
+    printf("🔢 Modified bytes : %llu of %llu\n", metrics->changed_bytes, metrics->pixel_bytes);
+    printf("📉 MSE            : %.8f\n", metrics_mse(metrics));
+    printf("📈 PSNR           : %.2f dB\n", metrics_psnr(metrics));
+
+    for (int c = 0; c < metrics->channels; c++)
+        printf("🎨 %s : +1 x %llu, -1 x %llu\n", names[c], metrics->changes[c][0], metrics->changes[c][1]);
+
+    if (metrics->padding_bytes > 0)
+        printf("🧱 Row padding : %llu byte(s) changed (not pixels, not in MSE)\n", metrics->padding_bytes);
+}
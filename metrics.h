@@ -0,0 +1,58 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "types.h"
+
+/* BMP pixel bytes are stored B, G, R; PNG pixels R, G, B (, A) */
+#define METRICS_MAX_CHANNELS 4
+
+/*
+ * Distortion of the stego image against its source, gathered
+ * while embedding. LSB replacement moves a byte by exactly +1
+ * or -1, so the squared error is the number of changed bytes
+ */
+typedef struct _StegoMetrics
+{
+    unsigned long long pixel_bytes;
+    unsigned long long changed_bytes;
+
+    /* changes[channel][0] = +1 steps, changes[channel][1] = -1 steps */
+    unsigned long long changes[METRICS_MAX_CHANNELS][2];
+
+    /*
+     * Changed bytes in the padding at the end of a row; not pixels, so
+     * they are kept out of changed_bytes (and MSE / PSNR)
+     */
+    unsigned long long padding_bytes;
+
+    /* Pixel bytes of a row, and row length including the padding */
+    long row_bytes;
+    long row_stride;
+
+    /* Bytes per pixel, and 1 if they are in R, G, B, A order (PNG) */
+    int channels;
+    int rgb_order;
+
+} StegoMetrics;
+
+/*
+ * Start a fresh measurement over pixel_bytes image bytes, stored as
+ * rows of row_bytes pixel bytes every row_stride bytes, with channels
+ * bytes per pixel in B, G, R order (or R, G, B, A when rgb_order)
+ */
+void init_metrics(StegoMetrics *metrics, unsigned long long pixel_bytes, long row_bytes, long row_stride,
+                  int channels, int rgb_order);
+
+/* Channel of the byte at image_pos, -1 if it is row padding */
+int metrics_channel(const StegoMetrics *metrics, long image_pos);
+
+/* Mean squared error over the whole pixel array */
+double metrics_mse(const StegoMetrics *metrics);
+
+/* Peak signal to noise ratio in dB (infinite if nothing changed) */
+double metrics_psnr(const StegoMetrics *metrics);
+
+/* Print the metrics block of the job report */
+void print_metrics(const StegoMetrics *metrics);
+
+#endif
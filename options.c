@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "options.h"
+#include "fec.h"
+#include "matrix.h"
+#include "png_stream.h"
+
+/* ---------------------------------------------------------------------
+ * init_options
+ * Default values used when a switch is not given.
+ * -------------------------------------------------------------------*/
+void init_options(StegoOptions *opts)
+{
+    opts->pipeline_buffers = DEFAULT_PIPELINE_BUFFERS;
+    opts->buffers_given = 0;
+    opts->fec_parity = 0;
+    opts->metrics = 0;
+    opts->threads = 0;
+    opts->matrix_k = 0;
+    opts->index_fname = NULL;
+    opts->png_level = DEFAULT_PNG_LEVEL;
+    opts->png_level_given = 0;
+}
+
+/* ---------------------------------------------------------------------
+ * parse_uint_option
+ * Parses the value of "--name=value" within [min, max].
+ * -------------------------------------------------------------------*/
+static Status parse_uint_option(const char *arg, const char *value, uint min, uint max, uint *out)
+{
+    char *end;
+    long n = strtol(value, &end, 10);
+
+    if (*value == '\0' || *end != '\0' || n < min || n > max)
+    {
+        printf("❌ ERROR: %s expects a number between %u and %u\n", arg, min, max);
+        return e_failure;
+    }
+
+    *out = n;
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * parse_options
+ * Pulls every "--name=value" switch out of argv so the positional
+ * arguments keep the indexes the operations expect.
+ * -------------------------------------------------------------------*/
+Status parse_options(int *argc, char *argv[], StegoOptions *opts)
+{
+    int kept = 1;
+
+    init_options(opts);
+
+    for (int i = 1; i < *argc; i++)
+    {
+        char *arg = argv[i];
+
+        if (strncmp(arg, "--", 2) != 0)
+        {
+            argv[kept++] = arg;
+            continue;
+        }
+
+        if (strncmp(arg, "--buffers=", 10) == 0)
+        {
+            if (parse_uint_option(arg, arg + 10, 2, MAX_PIPELINE_BUFFERS, &opts->pipeline_buffers) != e_success)
+                return e_failure;
+            opts->buffers_given = 1;
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0)
+        {
+            if (parse_uint_option(arg, arg + 10, 0, MAX_THREADS, &opts->threads) != e_success)
+                return e_failure;
+        }
+        else if (strncmp(arg, "--matrix=", 9) == 0)
+        {
+            if (parse_uint_option(arg, arg + 9, MATRIX_MIN_K, MATRIX_MAX_K, &opts->matrix_k) != e_success)
+                return e_failure;
+        }
+        else if (strncmp(arg, "--png-level=", 12) == 0)
+        {
+            if (parse_uint_option(arg, arg + 12, 0, 9, &opts->png_level) != e_success)
+                return e_failure;
+            opts->png_level_given = 1;
+        }
+        else if (strncmp(arg, "--index=", 8) == 0 && arg[8] != '\0')
+        {
+            opts->index_fname = arg + 8;
+        }
+        else if (strcmp(arg, "--metrics") == 0)
+        {
+            opts->metrics = 1;
+        }
+        else if (strncmp(arg, "--fec=", 6) == 0)
+        {
+            if (parse_uint_option(arg, arg + 6, FEC_MIN_PARITY, FEC_MAX_PARITY, &opts->fec_parity) != e_success)
+                return e_failure;
+        }
+        else
+        {
+            printf("❌ ERROR: Unknown option %s\n", arg);
+            return e_failure;
+        }
+    }
+
+    if (opts->fec_parity > 0 && opts->matrix_k > 0)
+    {
+        printf("❌ ERROR: --fec and --matrix cannot be combined\n");
+        return e_failure;
+    }
+
+    *argc = kept;
+    argv[kept] = NULL;
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * check_options_for_operation
+ * --fec and --matrix shape the payload written by -e (and read by -d,
+ * which also detects them on its own); --metrics is reported by -e.
+ * --buffers sizes the pipeline ring of -e, -d and the video modes,
+ * --png-level only matters where -e writes a PNG.
+ * -B runs -e / -d jobs and takes all of them.
+ * -------------------------------------------------------------------*/
+Status check_options_for_operation(OperationType op, const char *flag, const StegoOptions *opts)
+{
+    int payload_op = (op == e_encode || op == e_decode || op == e_batch);
+    int pipeline_op = payload_op || op == e_video_encode || op == e_video_decode;
+    const char *name = NULL;
+
+    if (op == e_unsupported)
+        return e_success;
+
+    if (opts->fec_parity > 0 && !payload_op)
+        name = "--fec";
+    else if (opts->matrix_k > 0 && !payload_op)
+        name = "--matrix";
+    else if (opts->metrics && op != e_encode && op != e_batch)
+        name = "--metrics";
+    else if (opts->buffers_given && !pipeline_op)
+        name = "--buffers";
+    else if (opts->png_level_given && op != e_encode && op != e_batch)
+        name = "--png-level";
+
+    if (name != NULL)
+    {
+        printf("❌ ERROR: %s is not supported with %s\n", name, flag);
+        return e_failure;
+    }
+
+    return e_success;
+}
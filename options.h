@@ -0,0 +1,52 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "types.h"
+
+/* Default number of buffers in the read/embed/write ring */
+#define DEFAULT_PIPELINE_BUFFERS 4
+#define MAX_PIPELINE_BUFFERS 64
+
+#define MAX_THREADS 1024
+
+/*
+ * Structure to store the optional "--name=value" switches
+ * given on the command line, shared by every operation
+ */
+typedef struct _StegoOptions
+{
+    /* Buffers in the pipeline ring (--buffers=N), buffers_given if set */
+    uint pipeline_buffers;
+    int buffers_given;
+
+    /* Reed-Solomon parity symbols per codeword, 0 = off (--fec=N) */
+    uint fec_parity;
+
+    /* Report MSE / PSNR / changed bytes after encoding (--metrics) */
+    int metrics;
+
+    /* Hamming code matrix embedding with k bits per 2^k - 1 bytes, 0 = off (--matrix=K) */
+    uint matrix_k;
+
+    /* Pick the carrier from this cover index instead of argv (--index=FILE) */
+    const char *index_fname;
+
+    /* zlib level for PNG stego images, 0..9 (--png-level=N), png_level_given if set */
+    uint png_level;
+    int png_level_given;
+
+    /* Worker threads for corpus analysis, 0 = one per CPU (--threads=N) */
+    uint threads;
+
+} StegoOptions;
+
+/* Fill opts with defaults */
+void init_options(StegoOptions *opts);
+
+/* Remove "--" switches from argv and store them in opts */
+Status parse_options(int *argc, char *argv[], StegoOptions *opts);
+
+/* Fail on switches the operation (given as its flag, e.g. "-u") would ignore */
+Status check_options_for_operation(OperationType op, const char *flag, const StegoOptions *opts);
+
+#endif
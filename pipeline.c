@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "pipeline.h"
+
+/*
+ * Shared ring state. Slot n lives in buffer n % buffer_count and moves
+ * read -> embedded -> written; the counters only grow, so a stage may
+ * work on slot n once the previous stage's counter has passed it.
+ */
+typedef struct _PipelineRing
+{
+    PipelineStages *stages;
+    PipelineSlot *slots;
+    uint buffer_count;
+    long total_data;
+    long slot_data;
+    long slot_count;
+
+    long read_done;
+    long embed_done;
+    long write_done;
+    int failed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} PipelineRing;
+
+/* ---------------------------------------------------------------------
+ * prepare_slot
+ * Sets the lengths of slot n before it is read.
+ * -------------------------------------------------------------------*/
+static long carrier_len_for(PipelineStages *stages, long data_len)
+{
+    if (stages->carrier_len)
+        return stages->carrier_len(stages->ctx, data_len);
+    return data_len * 8;
+}
+
+static void prepare_slot(PipelineRing *ring, long n)
+{
+    PipelineSlot *slot = &ring->slots[n % ring->buffer_count];
+    long left = ring->total_data - n * ring->slot_data;
+
+    slot->data_len = left < ring->slot_data ? left : ring->slot_data;
+    slot->carrier_len = carrier_len_for(ring->stages, slot->data_len);
+}
+
+/* ---------------------------------------------------------------------
+ * wait_for_slot
+ * Blocks until *ahead > n (previous stage done) and, for the reader,
+ * until a buffer is free (backpressure). Returns 0 if aborted.
+ * -------------------------------------------------------------------*/
+static int wait_for_slot(PipelineRing *ring, long n, long *ahead, int is_reader)
+{
+    pthread_mutex_lock(&ring->lock);
+
+    while (!ring->failed)
+    {
+        if (is_reader && n - ring->write_done < ring->buffer_count)
+            break;
+        if (!is_reader && *ahead > n)
+            break;
+        pthread_cond_wait(&ring->changed, &ring->lock);
+    }
+
+    int ok = !ring->failed;
+    pthread_mutex_unlock(&ring->lock);
+    return ok;
+}
+
+/* ---------------------------------------------------------------------
+ * finish_slot
+ * Publishes stage progress (or failure) and wakes the other stages.
+ * -------------------------------------------------------------------*/
+static void finish_slot(PipelineRing *ring, long *done, Status status)
+{
+    pthread_mutex_lock(&ring->lock);
+
+    if (status == e_success)
+        (*done)++;
+    else
+        ring->failed = 1;
+
+    pthread_cond_broadcast(&ring->changed);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+static void *read_thread(void *arg)
+{
+    PipelineRing *ring = arg;
+
+    for (long n = 0; n < ring->slot_count; n++)
+    {
+        if (!wait_for_slot(ring, n, NULL, 1))
+            break;
+        prepare_slot(ring, n);
+        finish_slot(ring, &ring->read_done,
+                    ring->stages->read_stage(ring->stages->ctx, &ring->slots[n % ring->buffer_count]));
+    }
+
+    return NULL;
+}
+
+static void *embed_thread(void *arg)
+{
+    PipelineRing *ring = arg;
+
+    for (long n = 0; n < ring->slot_count; n++)
+    {
+        if (!wait_for_slot(ring, n, &ring->read_done, 0))
+            break;
+        finish_slot(ring, &ring->embed_done,
+                    ring->stages->embed_stage(ring->stages->ctx, &ring->slots[n % ring->buffer_count]));
+    }
+
+    return NULL;
+}
+
+static void *write_thread(void *arg)
+{
+    PipelineRing *ring = arg;
+
+    for (long n = 0; n < ring->slot_count; n++)
+    {
+        if (!wait_for_slot(ring, n, &ring->embed_done, 0))
+            break;
+        finish_slot(ring, &ring->write_done,
+                    ring->stages->write_stage(ring->stages->ctx, &ring->slots[n % ring->buffer_count]));
+    }
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * ring_alloc / ring_free
+ * Ring memory from the job arena when there is one (freed with it).
+ * -------------------------------------------------------------------*/
+static void *ring_alloc(PipelineStages *stages, size_t size)
+{
+    return stages->arena ? arena_alloc(stages->arena, size) : malloc(size);
+}
+
+static void ring_free(PipelineStages *stages, void *ptr)
+{
+    if (stages->arena == NULL)
+        free(ptr);
+}
+
+/* ---------------------------------------------------------------------
+ * run_pipeline
+ * Overlaps reading, embedding and writing through a bounded ring of
+ * buffer_count reusable buffers. A job that fits in one buffer runs
+ * on the calling thread.
+ * -------------------------------------------------------------------*/
+Status run_pipeline(PipelineStages *stages, long total_data, uint buffer_count)
+{
+    PipelineRing ring = { 0 };
+    Status status = e_success;
+
+    ring.stages = stages;
+    ring.total_data = total_data;
+    ring.slot_data = stages->slot_data > 0 ? stages->slot_data : PIPELINE_SLOT_DATA;
+    ring.slot_count = (total_data + ring.slot_data - 1) / ring.slot_data;
+    ring.buffer_count = ring.slot_count < buffer_count ? ring.slot_count : buffer_count;
+
+    if (ring.slot_count == 0)
+        return e_success;
+
+    ring.slots = ring_alloc(stages, ring.buffer_count * sizeof(PipelineSlot));
+    if (ring.slots == NULL)
+        return e_failure;
+    memset(ring.slots, 0, ring.buffer_count * sizeof(PipelineSlot));
+
+    /* A one-slot job only needs buffers of its own size */
+    long buffer_data = ring.slot_count == 1 ? total_data : ring.slot_data;
+
+    for (uint i = 0; i < ring.buffer_count; i++)
+    {
+        ring.slots[i].carrier = ring_alloc(stages, carrier_len_for(stages, buffer_data));
+        ring.slots[i].data = ring_alloc(stages, buffer_data);
+        if (!ring.slots[i].carrier || !ring.slots[i].data)
+            status = e_failure;
+    }
+
+    if (status == e_success && ring.slot_count == 1)
+    {
+        prepare_slot(&ring, 0);
+        if (stages->read_stage(stages->ctx, &ring.slots[0]) != e_success
+            || stages->embed_stage(stages->ctx, &ring.slots[0]) != e_success
+            || stages->write_stage(stages->ctx, &ring.slots[0]) != e_success)
+            status = e_failure;
+    }
+    else if (status == e_success)
+    {
+        void *(*stage_threads[3])(void *) = { read_thread, embed_thread, write_thread };
+        pthread_t threads[3];
+        int started = 0;
+
+        pthread_mutex_init(&ring.lock, NULL);
+        pthread_cond_init(&ring.changed, NULL);
+
+        for (; started < 3; started++)
+        {
+            if (pthread_create(&threads[started], NULL, stage_threads[started], &ring) != 0)
+            {
+                perror("pthread_create");
+                finish_slot(&ring, NULL, e_failure);
+                break;
+            }
+        }
+
+        for (int i = 0; i < started; i++)
+            pthread_join(threads[i], NULL);
+
+        pthread_cond_destroy(&ring.changed);
+        pthread_mutex_destroy(&ring.lock);
+
+        if (ring.failed)
+            status = e_failure;
+    }
+
+    for (uint i = 0; i < ring.buffer_count; i++)
+    {
+        ring_free(stages, ring.slots[i].carrier);
+        ring_free(stages, ring.slots[i].data);
+    }
+    ring_free(stages, ring.slots);
+
+    return status;
+}
@@ -0,0 +1,44 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "types.h"
+#include "arena.h"
+
+/* Secret bytes carried by one ring buffer (8x that in image bytes) */
+#define PIPELINE_SLOT_DATA (16 * 1024)
+
+/*
+ * One reusable ring buffer: a block of image bytes and
+ * the secret bytes hidden in (or extracted from) it
+ */
+typedef struct _PipelineSlot
+{
+    char *carrier;
+    long carrier_len;
+    long carrier_pos;
+    char *data;
+    long data_len;
+} PipelineSlot;
+
+/*
+ * The three stages, each called in slot order on its own
+ * thread. carrier_len / data_len are set before read_stage.
+ * slot_data (0 = PIPELINE_SLOT_DATA) and carrier_len (NULL =
+ * 8 image bytes per secret byte) describe other embeddings.
+ * The ring buffers come from arena (NULL = heap).
+ */
+typedef struct _PipelineStages
+{
+    Status (*read_stage)(void *ctx, PipelineSlot *slot);
+    Status (*embed_stage)(void *ctx, PipelineSlot *slot);
+    Status (*write_stage)(void *ctx, PipelineSlot *slot);
+    void *ctx;
+    long slot_data;
+    long (*carrier_len)(void *ctx, long data_len);
+    Arena *arena;
+} PipelineStages;
+
+/* Run total_data secret bytes through read -> embed -> write */
+Status run_pipeline(PipelineStages *stages, long total_data, uint buffer_count);
+
+#endif
@@ -0,0 +1,621 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <zlib.h>
+#include "png_stream.h"
+
+/*
+ * PNG carriers. A PNG is the 8 byte signature followed by chunks
+ * (length, type, data, CRC); the pixels are the concatenated IDAT
+ * data, one zlib stream of rows each led by a filter type byte.
+ * The streams below inflate + unfilter (or filter + deflate) one row
+ * at a time behind a fopencookie FILE, so everything that reads or
+ * writes BMP pixels through stdio works on them as is.
+ */
+
+static const unsigned char png_signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/* Filter types (PNG spec, filter method 0) */
+enum { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH, PNG_FILTERS };
+
+typedef struct _PngReader
+{
+    FILE *fptr;
+    long idat_offset;
+    uint32_t chunk_left;
+    int need_crc;
+
+    z_stream zs;
+    unsigned char in[PNG_IO_BLOCK];
+
+    /* Current and previous row, filter byte first */
+    unsigned char *row;
+    unsigned char *prev;
+    long stride;
+    int bpp;
+
+    long row_pos;
+    long pos;
+    long total;
+} PngReader;
+
+typedef struct _PngWriter
+{
+    FILE *fptr;
+    z_stream zs;
+    unsigned char out[PNG_IO_BLOCK];
+    int level;
+
+    /* Row being filled, previous row and filter candidates */
+    unsigned char *row;
+    unsigned char *prev;
+    unsigned char *filtered;
+    unsigned char *best;
+    long stride;
+    int bpp;
+
+    long row_pos;
+    long pos;
+    long total;
+    int failed;
+} PngWriter;
+
+/* ---------------------------------------------------------------------
+ * is_png_name
+ * -------------------------------------------------------------------*/
+int is_png_name(const char *fname)
+{
+    int len = strlen(fname);
+
+    return len > 4 && strcasecmp(fname + len - 4, ".png") == 0;
+}
+
+static uint32_t get_be32(const unsigned char *ptr)
+{
+    return ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) | ((uint32_t)ptr[2] << 8) | ptr[3];
+}
+
+static void put_be32(unsigned char *ptr, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        ptr[i] = value >> (24 - 8 * i);
+}
+
+/* ---------------------------------------------------------------------
+ * read_png_header
+ * Checks the signature and IHDR, then stops at the first IDAT chunk.
+ * copy (may be NULL) receives every byte before that chunk.
+ * -------------------------------------------------------------------*/
+static Status read_png_header(FILE *fptr, PngInfo *info, FILE *copy)
+{
+    unsigned char buff[PNG_IO_BLOCK];
+    int have_ihdr = 0;
+
+    if (fread(buff, 1, 8, fptr) != 8 || memcmp(buff, png_signature, 8) != 0)
+        return e_failure;
+    if (copy && fwrite(buff, 1, 8, copy) != 8)
+        return e_failure;
+
+    while (fread(buff, 1, 8, fptr) == 8)
+    {
+        uint32_t len = get_be32(buff);
+
+        if (memcmp(buff + 4, "IDAT", 4) == 0)
+        {
+            fseek(fptr, -8, SEEK_CUR);
+            return have_ihdr ? e_success : e_failure;
+        }
+
+        if (memcmp(buff + 4, "IHDR", 4) == 0)
+        {
+            unsigned char *ihdr = buff + 8;
+
+            /* 8-bit, colour type 2 (RGB) or 6 (RGBA), no interlace */
+            if (len != 13 || fread(ihdr, 1, 13, fptr) != 13
+                || ihdr[8] != 8 || (ihdr[9] != 2 && ihdr[9] != 6)
+                || ihdr[10] != 0 || ihdr[11] != 0 || ihdr[12] != 0)
+                return e_failure;
+
+            info->width = get_be32(ihdr);
+            info->height = get_be32(ihdr + 4);
+            info->channels = ihdr[9] == 6 ? 4 : 3;
+            info->pixel_bytes = (long)info->width * info->height * info->channels;
+            have_ihdr = info->width > 0 && info->height > 0;
+
+            if (copy && fwrite(buff, 1, 8 + 13, copy) != 8 + 13)
+                return e_failure;
+            len = 0;
+        }
+        else if (copy && fwrite(buff, 1, 8, copy) != 8)
+            return e_failure;
+
+        /* Rest of the chunk data and its CRC */
+        for (long left = (long)len + 4; left > 0; )
+        {
+            long n = left < PNG_IO_BLOCK ? left : PNG_IO_BLOCK;
+
+            if (fread(buff, 1, n, fptr) != n || (copy && fwrite(buff, 1, n, copy) != n))
+                return e_failure;
+            left -= n;
+        }
+    }
+
+    return e_failure;
+}
+
+/* ---------------------------------------------------------------------
+ * paeth
+ * -------------------------------------------------------------------*/
+static unsigned char paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+/* ---------------------------------------------------------------------
+ * unfilter_row
+ * Undoes the row's filter in place (row[0] is the filter type).
+ * -------------------------------------------------------------------*/
+static Status unfilter_row(unsigned char *row, const unsigned char *prev, long stride, int bpp)
+{
+    unsigned char *x = row + 1;
+    const unsigned char *p = prev + 1;
+    long i;
+
+    switch (row[0])
+    {
+    case PNG_FILTER_NONE:
+        break;
+    case PNG_FILTER_SUB:
+        for (i = bpp; i < stride; i++)
+            x[i] += x[i - bpp];
+        break;
+    case PNG_FILTER_UP:
+        for (i = 0; i < stride; i++)
+            x[i] += p[i];
+        break;
+    case PNG_FILTER_AVG:
+        for (i = 0; i < bpp; i++)
+            x[i] += p[i] >> 1;
+        for (; i < stride; i++)
+            x[i] += (x[i - bpp] + p[i]) >> 1;
+        break;
+    case PNG_FILTER_PAETH:
+        for (i = 0; i < bpp; i++)
+            x[i] += p[i];
+        for (; i < stride; i++)
+            x[i] += paeth(x[i - bpp], p[i], p[i - bpp]);
+        break;
+    default:
+        return e_failure;
+    }
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * next_row
+ * Inflates and unfilters the next row, pulling IDAT data as needed.
+ * -------------------------------------------------------------------*/
+static Status next_row(PngReader *r)
+{
+    unsigned char *tmp = r->prev;
+
+    r->prev = r->row;
+    r->row = tmp;
+
+    r->zs.next_out = r->row;
+    r->zs.avail_out = r->stride + 1;
+
+    while (r->zs.avail_out > 0)
+    {
+        if (r->zs.avail_in == 0)
+        {
+            unsigned char hdr[8];
+
+            while (r->chunk_left == 0)
+            {
+                if ((r->need_crc && fread(hdr, 1, 4, r->fptr) != 4)
+                    || fread(hdr, 1, 8, r->fptr) != 8 || memcmp(hdr + 4, "IDAT", 4) != 0)
+                    return e_failure;
+                r->chunk_left = get_be32(hdr);
+                r->need_crc = 1;
+            }
+
+            uint32_t n = r->chunk_left < sizeof(r->in) ? r->chunk_left : sizeof(r->in);
+            if (fread(r->in, 1, n, r->fptr) != n)
+                return e_failure;
+
+            r->chunk_left -= n;
+            r->zs.next_in = r->in;
+            r->zs.avail_in = n;
+        }
+
+        int ret = inflate(&r->zs, Z_NO_FLUSH);
+        if (ret != Z_OK && !(ret == Z_STREAM_END && r->zs.avail_out == 0))
+            return e_failure;
+    }
+
+    r->row_pos = 0;
+    return unfilter_row(r->row, r->prev, r->stride, r->bpp);
+}
+
+/* ---------------------------------------------------------------------
+ * restart_reader
+ * Back to the first pixel: rewinds to the first IDAT, resets inflate.
+ * -------------------------------------------------------------------*/
+static Status restart_reader(PngReader *r)
+{
+    if (fseek(r->fptr, r->idat_offset, SEEK_SET) != 0 || inflateReset(&r->zs) != Z_OK)
+        return e_failure;
+
+    r->chunk_left = 0;
+    r->need_crc = 0;
+    r->zs.avail_in = 0;
+    memset(r->row, 0, r->stride + 1);
+    r->row_pos = r->stride;
+    r->pos = 0;
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * Cookie functions of the read stream
+ * -------------------------------------------------------------------*/
+static ssize_t png_read(void *cookie, char *buf, size_t size)
+{
+    PngReader *r = cookie;
+    size_t done = 0;
+
+    while (done < size && r->pos < r->total)
+    {
+        if (r->row_pos == r->stride && next_row(r) != e_success)
+            return -1;
+
+        long n = r->stride - r->row_pos;
+        if (n > size - done)
+            n = size - done;
+
+        memcpy(buf + done, r->row + 1 + r->row_pos, n);
+        r->row_pos += n;
+        r->pos += n;
+        done += n;
+    }
+
+    return done;
+}
+
+static int png_read_seek(void *cookie, off64_t *offset, int whence)
+{
+    PngReader *r = cookie;
+    long target = *offset + (whence == SEEK_CUR ? r->pos : whence == SEEK_END ? r->total : 0);
+
+    if (target < 0 || target > r->total)
+        return -1;
+
+    if (target < r->pos && restart_reader(r) != e_success)
+        return -1;
+
+    /* Forward: decode and drop the rows in between */
+    while (r->pos < target)
+    {
+        if (r->row_pos == r->stride && next_row(r) != e_success)
+            return -1;
+
+        long n = r->stride - r->row_pos;
+        if (n > target - r->pos)
+            n = target - r->pos;
+
+        r->row_pos += n;
+        r->pos += n;
+    }
+
+    *offset = target;
+    return 0;
+}
+
+static int png_read_close(void *cookie)
+{
+    PngReader *r = cookie;
+
+    inflateEnd(&r->zs);
+    fclose(r->fptr);
+    free(r->row);
+    free(r->prev);
+    free(r);
+    return 0;
+}
+
+/* ---------------------------------------------------------------------
+ * png_open_pixels
+ * -------------------------------------------------------------------*/
+FILE *png_open_pixels(const char *fname, PngInfo *info)
+{
+    PngReader *r = calloc(1, sizeof(*r));
+    cookie_io_functions_t io = { png_read, NULL, png_read_seek, png_read_close };
+    FILE *stream;
+
+    if (r == NULL || (r->fptr = fopen(fname, "rb")) == NULL)
+    {
+        free(r);
+        return NULL;
+    }
+
+    if (read_png_header(r->fptr, info, NULL) == e_success && inflateInit(&r->zs) == Z_OK)
+    {
+        r->idat_offset = ftell(r->fptr);
+        r->bpp = info->channels;
+        r->stride = (long)info->width * info->channels;
+        r->total = info->pixel_bytes;
+        r->row = malloc(r->stride + 1);
+        r->prev = malloc(r->stride + 1);
+
+        if (r->row && r->prev && restart_reader(r) == e_success
+            && (stream = fopencookie(r, "rb", io)) != NULL)
+            return stream;
+
+        inflateEnd(&r->zs);
+    }
+
+    fclose(r->fptr);
+    free(r->row);
+    free(r->prev);
+    free(r);
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------
+ * write_chunk
+ * -------------------------------------------------------------------*/
+static Status write_chunk(FILE *fptr, const char *type, const unsigned char *data, uint32_t len)
+{
+    unsigned char hdr[8], crc[4];
+    uLong sum = crc32(crc32(0, NULL, 0), (const Bytef *)type, 4);
+
+    put_be32(hdr, len);
+    memcpy(hdr + 4, type, 4);
+    if (len > 0)
+        sum = crc32(sum, data, len);
+    put_be32(crc, sum);
+
+    if (fwrite(hdr, 1, 8, fptr) != 8 || fwrite(data, 1, len, fptr) != len || fwrite(crc, 1, 4, fptr) != 4)
+        return e_failure;
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * deflate_into_idat
+ * Runs deflate over the pending input, writing a full IDAT chunk
+ * every time the output block fills up.
+ * -------------------------------------------------------------------*/
+static Status deflate_into_idat(PngWriter *w, int flush)
+{
+    int ret;
+
+    do
+    {
+        ret = deflate(&w->zs, flush);
+        if (ret == Z_STREAM_ERROR)
+            return e_failure;
+
+        if (w->zs.avail_out == 0 || (flush == Z_FINISH && ret == Z_STREAM_END))
+        {
+            uint32_t len = sizeof(w->out) - w->zs.avail_out;
+
+            if (len > 0 && write_chunk(w->fptr, "IDAT", w->out, len) != e_success)
+                return e_failure;
+
+            w->zs.next_out = w->out;
+            w->zs.avail_out = sizeof(w->out);
+        }
+    } while (w->zs.avail_in > 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * filter_row
+ * Applies filter type f to w->row into out. Returns the sum of the
+ * filtered bytes as signed values (the usual "minimum sum of absolute
+ * differences" heuristic picks the filter).
+ * -------------------------------------------------------------------*/
+static long filter_row(PngWriter *w, int f, unsigned char *out)
+{
+    const unsigned char *x = w->row + 1, *p = w->prev + 1;
+    unsigned char *o = out + 1;
+    long sum = 0;
+    int bpp = w->bpp;
+
+    out[0] = f;
+
+    for (long i = 0; i < w->stride; i++)
+    {
+        int a = i >= bpp ? x[i - bpp] : 0;
+        int c = i >= bpp ? p[i - bpp] : 0;
+
+        switch (f)
+        {
+        case PNG_FILTER_NONE:  o[i] = x[i]; break;
+        case PNG_FILTER_SUB:   o[i] = x[i] - a; break;
+        case PNG_FILTER_UP:    o[i] = x[i] - p[i]; break;
+        case PNG_FILTER_AVG:   o[i] = x[i] - ((a + p[i]) >> 1); break;
+        default:               o[i] = x[i] - paeth(a, p[i], c); break;
+        }
+
+        sum += o[i] < 128 ? o[i] : 256 - o[i];
+    }
+
+    return sum;
+}
+
+/* ---------------------------------------------------------------------
+ * flush_row
+ * Filters the completed row and feeds it to deflate.
+ * -------------------------------------------------------------------*/
+static Status flush_row(PngWriter *w)
+{
+    if (w->level == 0)
+    {
+        filter_row(w, PNG_FILTER_NONE, w->best);
+    }
+    else
+    {
+        long best = -1;
+
+        for (int f = 0; f < PNG_FILTERS; f++)
+        {
+            long sum = filter_row(w, f, w->filtered);
+
+            if (best < 0 || sum < best)
+            {
+                unsigned char *tmp = w->best;
+
+                w->best = w->filtered;
+                w->filtered = tmp;
+                best = sum;
+            }
+        }
+    }
+
+    w->zs.next_in = w->best;
+    w->zs.avail_in = w->stride + 1;
+    if (deflate_into_idat(w, Z_NO_FLUSH) != e_success)
+        return e_failure;
+
+    unsigned char *tmp = w->prev;
+    w->prev = w->row;
+    w->row = tmp;
+    w->row_pos = 0;
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * Cookie functions of the write stream
+ * -------------------------------------------------------------------*/
+static ssize_t png_write(void *cookie, const char *buf, size_t size)
+{
+    PngWriter *w = cookie;
+    size_t done = 0;
+
+    if (w->failed || size > w->total - w->pos)
+    {
+        w->failed = 1;
+        return 0;
+    }
+
+    while (done < size)
+    {
+        long n = w->stride - w->row_pos;
+        if (n > size - done)
+            n = size - done;
+
+        memcpy(w->row + 1 + w->row_pos, buf + done, n);
+        w->row_pos += n;
+        w->pos += n;
+        done += n;
+
+        if (w->row_pos == w->stride && flush_row(w) != e_success)
+        {
+            w->failed = 1;
+            return 0;
+        }
+    }
+
+    return done;
+}
+
+static int png_write_seek(void *cookie, off64_t *offset, int whence)
+{
+    PngWriter *w = cookie;
+
+    /* Sequential only: ftell, or a seek to where the stream already is */
+    if ((whence == SEEK_CUR && *offset == 0) || (whence == SEEK_SET && *offset == w->pos))
+    {
+        *offset = w->pos;
+        return 0;
+    }
+
+    return -1;
+}
+
+static int png_write_close(void *cookie)
+{
+    PngWriter *w = cookie;
+    int ok = !w->failed && w->pos == w->total;
+
+    if (ok)
+    {
+        w->zs.avail_in = 0;
+        ok = deflate_into_idat(w, Z_FINISH) == e_success
+             && write_chunk(w->fptr, "IEND", NULL, 0) == e_success;
+    }
+
+    deflateEnd(&w->zs);
+    if (fclose(w->fptr) != 0)
+        ok = 0;
+
+    free(w->row);
+    free(w->prev);
+    free(w->filtered);
+    free(w->best);
+    free(w);
+    return ok ? 0 : EOF;
+}
+
+/* ---------------------------------------------------------------------
+ * png_create_pixels
+ * -------------------------------------------------------------------*/
+FILE *png_create_pixels(const char *fname, const char *src_fname, int level)
+{
+    PngWriter *w = calloc(1, sizeof(*w));
+    cookie_io_functions_t io = { NULL, png_write, png_write_seek, png_write_close };
+    FILE *fptr_src = fopen(src_fname, "rb");
+    PngInfo info;
+    FILE *stream;
+
+    if (w == NULL || fptr_src == NULL || (w->fptr = fopen(fname, "wb")) == NULL)
+    {
+        if (fptr_src)
+            fclose(fptr_src);
+        free(w);
+        return NULL;
+    }
+
+    Status status = read_png_header(fptr_src, &info, w->fptr);
+    fclose(fptr_src);
+
+    if (status == e_success
+        && deflateInit2(&w->zs, level, Z_DEFLATED, 15, 8, level ? Z_FILTERED : Z_DEFAULT_STRATEGY) == Z_OK)
+    {
+        w->level = level;
+        w->bpp = info.channels;
+        w->stride = (long)info.width * info.channels;
+        w->total = info.pixel_bytes;
+        w->row = malloc(w->stride + 1);
+        w->prev = calloc(1, w->stride + 1);
+        w->filtered = malloc(w->stride + 1);
+        w->best = malloc(w->stride + 1);
+        w->zs.next_out = w->out;
+        w->zs.avail_out = sizeof(w->out);
+
+        if (w->row && w->prev && w->filtered && w->best
+            && (stream = fopencookie(w, "wb", io)) != NULL)
+            return stream;
+
+        deflateEnd(&w->zs);
+    }
+
+    fclose(w->fptr);
+    free(w->row);
+    free(w->prev);
+    free(w->filtered);
+    free(w->best);
+    free(w);
+    return NULL;
+}
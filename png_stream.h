@@ -0,0 +1,41 @@
+#ifndef PNG_STREAM_H
+#define PNG_STREAM_H
+
+#include <stdio.h>
+#include "types.h"
+
+/* Compressed bytes moved per read / IDAT chunk written */
+#define PNG_IO_BLOCK (64 * 1024)
+
+#define DEFAULT_PNG_LEVEL 6
+
+/* Fields of the PNG header used by the tools (8-bit RGB / RGBA only) */
+typedef struct _PngInfo
+{
+    uint width;
+    uint height;
+    uint channels;
+    long pixel_bytes;
+} PngInfo;
+
+/* 1 if fname ends in ".png" */
+int is_png_name(const char *fname);
+
+/*
+ * Pixel streams: stdio streams over the unfiltered pixel bytes of a
+ * PNG, row after row (RGB or RGBA order), so the BMP stages can read
+ * and write them unchanged with the pixels at offset 0. Rows are
+ * inflated / deflated as they are reached, memory is a few rows.
+ */
+
+/* Read stream of the pixels of fname. Backward seeks restart the inflate */
+FILE *png_open_pixels(const char *fname, PngInfo *info);
+
+/*
+ * Write stream producing fname with the header chunks of src_fname
+ * (everything before its first IDAT). Exactly info->pixel_bytes must
+ * be written; fclose finishes the image and fails if it is short.
+ */
+FILE *png_create_pixels(const char *fname, const char *src_fname, int level);
+
+#endif
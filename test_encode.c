@@ -1,19 +1,58 @@
 #include "encode.h"
+#include "update.h"
+#include "analyze.h"
+#include "carrier_index.h"
+#include "video.h"
+#include "batch.h"
 
 int main(int argc, char *argv[])
 {
+    /* ---------------------------------------------------------
+    * 0. Pull out optional "--name=value" switches
+    * ---------------------------------------------------------*/
+    StegoOptions opts;
+
+    if (parse_options(&argc, argv, &opts) != e_success)
+        return 0;
+
+    /* Streams, stdio buffers and arena of the encode / decode jobs */
+    static StegoJob job;
+    init_job(&job);
+
     /* ---------------------------------------------------------
     * 3. Validate number of arguments for Encodeing
     * ---------------------------------------------------------*/
-    if (argc < 3 || argc > 5)
+    if (argc < 3)
     {
         printf("\n🚫 ERROR: Not enough arguments!\n");
         printf("\n📌 Usage :\n");
         printf("   -------------------------------------------------------\n");
         printf("   🔹 Encoding:\n");
-        printf("       ./a.out -e <input.bmp> <secret.txt> <output.bmp>\n");
+        printf("       ./a.out -e <input.bmp|.png> <secret.txt> <output.bmp|.png>\n");
         printf("\n   🔹 Decoding:\n");
-        printf("       ./a.out -d <stego.bmp> <decoded_output_file(optional)>\n");
+        printf("       ./a.out -d <stego.bmp|.png> <decoded_output_file(optional)>\n");
+        printf("\n   🔹 Fan-out Encoding:\n");
+        printf("       ./a.out -m <input.bmp> <secret1> <output1.bmp> [<secret2> <output2.bmp> ...]\n");
+        printf("\n   🔹 In-place Update:\n");
+        printf("       ./a.out -u <stego.bmp> <new_secret.txt>\n");
+        printf("\n   🔹 Steganalysis:\n");
+        printf("       ./a.out -a <image1.bmp> [image2.bmp ...]\n");
+        printf("\n   🔹 Cover Index:\n");
+        printf("       ./a.out -i <cover_dir> <covers.idx>\n");
+        printf("\n   🔹 Batch (one \"-e ...\" / \"-d ...\" job per line, one reused context):\n");
+        printf("       ./a.out -B <jobs.txt>\n");
+        printf("\n   🔹 Y4M Video (streams, \"-\" = stdin / stdout):\n");
+        printf("       ./a.out -v <input.y4m> <secret.txt> [output.y4m]\n");
+        printf("       ./a.out -V <stego.y4m> <decoded_output_file(optional)>\n");
+        printf("       ./a.out -e --index=<covers.idx> <secret.txt> <output.bmp>\n");
+        printf("\n   🔹 Options:\n");
+        printf("       --buffers=N   pipeline ring buffers (default %d)\n", DEFAULT_PIPELINE_BUFFERS);
+        printf("       --threads=N   analysis worker threads (default: one per CPU)\n");
+        printf("       --png-level=N zlib level of PNG stego images, 0..9 (default %d)\n", DEFAULT_PNG_LEVEL);
+        printf("       --index=FILE  pick the smallest fitting carrier from a cover index\n");
+        printf("       --matrix=K    Hamming matrix embedding, K bits per 2^K-1 bytes (%d..%d)\n", MATRIX_MIN_K, MATRIX_MAX_K);
+        printf("       --metrics     report MSE / PSNR / modified bytes after encoding\n");
+        printf("       --fec=N       Reed-Solomon protect payload with N parity symbols (%d..%d)\n", FEC_MIN_PARITY, FEC_MAX_PARITY);
         printf("   -------------------------------------------------------\n\n");
         return 0;
     }
@@ -22,12 +61,38 @@ int main(int argc, char *argv[])
      * ---------------------------------------------------------*/
     OperationType op = check_operation_type(argv);
 
+    if (check_options_for_operation(op, argv[1], &opts) != e_success)
+        return 0;
+
     /* ---------------------------------------------------------
      * 2. Encoding Operation
      * ---------------------------------------------------------*/
     if (op == e_encode)
     {
         EncodeInfo encInfo;
+        encInfo.opts = &opts;
+        encInfo.job = &job;
+
+        /* ---------------------------------------------------------
+        * Carrier from the cover index: -e <secret.txt> [output.bmp]
+        * ---------------------------------------------------------*/
+        if (opts.index_fname != NULL)
+        {
+            static char carrier[4096];
+
+            if (argc < 3 || argc > 4
+                || select_carrier_for_secret(&opts, argv[2], carrier, sizeof(carrier)) != e_success)
+            {
+                printf("❌ ERROR: No carrier selected from index!\n");
+                return 0;
+            }
+
+            /* argv has room: the --index switch was taken out of it */
+            for (int i = argc; i >= 2; i--)
+                argv[i + 1] = argv[i];
+            argv[2] = carrier;
+            argc++;
+        }
 
         /* ---------------------------------------------------------
         * 3. Validate number of arguments for Encodeing
@@ -38,7 +103,7 @@ int main(int argc, char *argv[])
             printf("\n📌 Usage :\n");
             printf("   -------------------------------------------------------\n");
             printf("   🔹 Encoding:\n");
-            printf("       ./a.out -e <input.bmp> <secret.txt> <output.bmp>\n");
+            printf("       ./a.out -e <input.bmp|.png> <secret.txt> <output.bmp|.png>\n");
             printf("   -------------------------------------------------------\n\n");
             return 0;
         }
@@ -50,6 +115,7 @@ int main(int argc, char *argv[])
             printf("📘 Validation Successful. Starting Encoding...\n\n");
 
             do_encoding(&encInfo);
+            close_job(&job);
             return 0;
         }
         else
@@ -65,6 +131,8 @@ int main(int argc, char *argv[])
     else if (op == e_decode)
     {
         DecodeInfo decInfo;
+        decInfo.opts = &opts;
+        decInfo.job = &job;
 
         /* ---------------------------------------------------------
         * 5. Validate number of arguments for Encodeing
@@ -75,7 +143,7 @@ int main(int argc, char *argv[])
             printf("\n📌 Usage :\n");
             printf("   -------------------------------------------------------\n");
             printf("\n   🔹 Decoding:\n");
-            printf("       ./a.out -d <stego.bmp> <decoded_output_file(optional)>\n");
+            printf("       ./a.out -d <stego.bmp|.png> <decoded_output_file(optional)>\n");
             printf("   -------------------------------------------------------\n\n");
             return 0;
         }
@@ -87,6 +155,7 @@ int main(int argc, char *argv[])
             printf("📘 Validation Successful. Starting Decoding...\n\n");
 
             do_decoding(&decInfo);
+            close_job(&job);
             return 0;
         }
         else
@@ -97,7 +166,158 @@ int main(int argc, char *argv[])
     }
 
     /* ---------------------------------------------------------
-     * 6. Unsupported Operation
+     * 6. Fan-out Encoding Operation (one carrier, many outputs)
+     * ---------------------------------------------------------*/
+    else if (op == e_encode_bulk)
+    {
+        BulkEncodeInfo bulkInfo;
+
+        if (read_and_validate_bulk_encode_args(argc, argv, &bulkInfo) == e_success)
+        {
+            printf("\n📚 MODE : Fan-out Encoding Selected\n");
+            printf("📘 Validation Successful. Starting Encoding...\n\n");
+
+            do_bulk_encoding(&bulkInfo);
+            return 0;
+        }
+        else
+        {
+            printf("❌ ERROR: Fan-out encoding validation failed!\n");
+            return 0;
+        }
+    }
+
+    /* ---------------------------------------------------------
+     * 7. In-place Update of an existing stego image
+     * ---------------------------------------------------------*/
+    else if (op == e_update)
+    {
+        EncodeInfo encInfo;
+        encInfo.opts = &opts;
+
+        if (argc != 4)
+        {
+            printf("\n🚫 ERROR: Not enough arguments!\n");
+            printf("\n📌 Usage :\n");
+            printf("   -------------------------------------------------------\n");
+            printf("   🔹 In-place Update:\n");
+            printf("       ./a.out -u <stego.bmp> <new_secret.txt>\n");
+            printf("   -------------------------------------------------------\n\n");
+            return 0;
+        }
+
+        if (read_and_validate_update_args(argv, &encInfo) == e_success)
+        {
+            printf("\n✏️  MODE : In-place Update Selected\n");
+            printf("📘 Validation Successful. Starting Update...\n\n");
+
+            do_update(&encInfo);
+            return 0;
+        }
+        else
+        {
+            printf("❌ ERROR: Update validation failed!\n");
+            return 0;
+        }
+    }
+
+    /* ---------------------------------------------------------
+     * 8. Steganalysis of a corpus (no magic string needed)
+     * ---------------------------------------------------------*/
+    else if (op == e_analyze)
+    {
+        printf("\n🔎 MODE : Steganalysis Selected\n");
+
+        do_analysis(argv + 2, argc - 2, opts.threads);
+        return 0;
+    }
+
+    /* ---------------------------------------------------------
+     * 9. Cover index build / refresh
+     * ---------------------------------------------------------*/
+    else if (op == e_index)
+    {
+        if (argc != 4)
+        {
+            printf("\n🚫 ERROR: Not enough arguments!\n");
+            printf("\n📌 Usage :\n");
+            printf("   -------------------------------------------------------\n");
+            printf("   🔹 Cover Index:\n");
+            printf("       ./a.out -i <cover_dir> <covers.idx>\n");
+            printf("   -------------------------------------------------------\n\n");
+            return 0;
+        }
+
+        printf("\n🗂️  MODE : Cover Index Selected\n");
+
+        do_build_index(argv[2], argv[3]);
+        return 0;
+    }
+
+    /* ---------------------------------------------------------
+     * 10. Y4M video encode (progress on stderr when the video
+     *     goes to stdout)
+     * ---------------------------------------------------------*/
+    else if (op == e_video_encode)
+    {
+        VideoInfo vidInfo;
+        vidInfo.opts = &opts;
+
+        if (argc < 4 || argc > 5)
+        {
+            fprintf(stderr, "\n🚫 ERROR: Usage: ./a.out -v <input.y4m|-> <secret.txt> [output.y4m|-]\n\n");
+            return 0;
+        }
+
+        if (read_and_validate_video_encode_args(argc, argv, &vidInfo) == e_success)
+        {
+            fprintf(vidInfo.log, "\n🎬 MODE : Video Encoding Selected\n");
+            do_video_encoding(&vidInfo);
+        }
+        return 0;
+    }
+
+    /* ---------------------------------------------------------
+     * 11. Y4M video decode
+     * ---------------------------------------------------------*/
+    else if (op == e_video_decode)
+    {
+        VideoInfo vidInfo;
+        vidInfo.opts = &opts;
+
+        if (argc > 4)
+        {
+            printf("\n🚫 ERROR: Usage: ./a.out -V <stego.y4m|-> [output]\n\n");
+            return 0;
+        }
+
+        if (read_and_validate_video_decode_args(argc, argv, &vidInfo) == e_success)
+        {
+            printf("\n🎬 MODE : Video Decoding Selected\n");
+            do_video_decoding(&vidInfo);
+        }
+        return 0;
+    }
+
+    /* ---------------------------------------------------------
+     * 12. Batch of small encode / decode jobs
+     * ---------------------------------------------------------*/
+    else if (op == e_batch)
+    {
+        if (argc != 3)
+        {
+            printf("\n🚫 ERROR: Usage: ./a.out -B <jobs.txt>\n\n");
+            return 0;
+        }
+
+        printf("\n📦 MODE : Batch Selected\n");
+
+        do_batch(argv[2], &opts, &job);
+        return 0;
+    }
+
+    /* ---------------------------------------------------------
+     * 13. Unsupported Operation
      * ---------------------------------------------------------*/
     else
     {
@@ -106,9 +326,22 @@ int main(int argc, char *argv[])
         printf("\n📌 Usage :\n");
         printf("   -------------------------------------------------------\n");
         printf("   🔹 Encoding:\n");
-        printf("       ./a.out -e <input.bmp> <secret.txt> <output.bmp>\n");
+        printf("       ./a.out -e <input.bmp|.png> <secret.txt> <output.bmp|.png>\n");
         printf("\n   🔹 Decoding:\n");
-        printf("       ./a.out -d <stego.bmp> <decoded_output_file(optional)>\n");
+        printf("       ./a.out -d <stego.bmp|.png> <decoded_output_file(optional)>\n");
+        printf("\n   🔹 Fan-out Encoding:\n");
+        printf("       ./a.out -m <input.bmp> <secret1> <output1.bmp> [<secret2> <output2.bmp> ...]\n");
+        printf("\n   🔹 In-place Update:\n");
+        printf("       ./a.out -u <stego.bmp> <new_secret.txt>\n");
+        printf("\n   🔹 Steganalysis:\n");
+        printf("       ./a.out -a <image1.bmp> [image2.bmp ...]\n");
+        printf("\n   🔹 Cover Index:\n");
+        printf("       ./a.out -i <cover_dir> <covers.idx>\n");
+        printf("\n   🔹 Batch (one \"-e ...\" / \"-d ...\" job per line, one reused context):\n");
+        printf("       ./a.out -B <jobs.txt>\n");
+        printf("\n   🔹 Y4M Video (streams, \"-\" = stdin / stdout):\n");
+        printf("       ./a.out -v <input.y4m> <secret.txt> [output.y4m]\n");
+        printf("       ./a.out -V <stego.y4m> <decoded_output_file(optional)>\n");
         printf("   -------------------------------------------------------\n\n");
 
         return 0;
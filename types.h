@@ -15,6 +15,13 @@ typedef enum
 {
     e_encode,
     e_decode,
+    e_encode_bulk,
+    e_update,
+    e_analyze,
+    e_index,
+    e_video_encode,
+    e_video_decode,
+    e_batch,
     e_unsupported
 } OperationType;
 
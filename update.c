@@ -0,0 +1,210 @@
+#define _GNU_SOURCE
+#include "update.h"
+#include <unistd.h>
+
+/*
+ * In-place update of an existing stego image. Only the payload region
+ * (magic .. data) is read; the new payload is encoded into a copy of
+ * it and just the differing image bytes are written back, data region
+ * first and header (magic, extn, size) last.
+ */
+
+/* ---------------------------------------------------------------------
+ * read_and_validate_update_args
+ * argv[2] : existing stego BMP (rewritten in place)
+ * argv[3] : new secret file
+ * -------------------------------------------------------------------*/
+Status read_and_validate_update_args(char *argv[], EncodeInfo *encInfo)
+{
+    int len = strlen(argv[2]);
+    if (len < 4 || strcmp(argv[2] + len - 4, ".bmp") != 0)
+    {
+        printf("❌ ERROR: Stego image must be \".bmp\"\n");
+        return e_failure;
+    }
+
+    if (argv[3] == NULL)
+    {
+        printf("❌ ERROR: Secret file must include extension (e.g., file.txt)\n");
+        return e_failure;
+    }
+
+    if (check_secret_extn(argv[3]) != e_success)
+        return e_failure;
+
+    encInfo->stego_image_fname = argv[2];
+    encInfo->src_image_fname = argv[2];
+    encInfo->secret_fname = argv[3];
+
+    printf("🗃️  Stego image to update : %s\n", argv[2]);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * read_old_payload_span
+ * Decodes the current header from the stego image and returns how many
+ * image bytes the old payload occupies (0 if not a stego image).
+ * old_extn_size receives the length of the old extension.
+ * -------------------------------------------------------------------*/
+static long read_old_payload_span(FILE *fptr, long image_size, long *old_extn_size)
+{
+    int magic_len = strlen(MAGIC_STRING);
+    unsigned char buff[32];
+    char magic[magic_len + 1];
+
+    fseek(fptr, 54, SEEK_SET);
+    for (int i = 0; i < magic_len; i++)
+    {
+        if (fread(buff, 8, 1, fptr) != 1)
+            return 0;
+        magic[i] = decode_byte_to_lsb(buff);
+    }
+    magic[magic_len] = '\0';
+
+    if (strcmp(magic, MAGIC_STRING) != 0 || fread(buff, 32, 1, fptr) != 1)
+        return 0;
+
+    long extn_size = decode_size_to_lsb(buff);
+    if (extn_size > image_size / 8 || fseek(fptr, extn_size * 8, SEEK_CUR) != 0
+        || fread(buff, 32, 1, fptr) != 1)
+        return 0;
+
+    long old_size = decode_size_to_lsb(buff);
+    long span = get_payload_span(extn_size, old_size);
+    *old_extn_size = extn_size;
+
+    printf("📦 Current payload : %ld bytes (extension %ld bytes)\n", old_size, extn_size);
+    return (54 + span <= image_size) ? span : 0;
+}
+
+/* ---------------------------------------------------------------------
+ * write_changed_bytes
+ * pwrites runs of bytes in [from, to) where old and new differ.
+ * -------------------------------------------------------------------*/
+static Status write_changed_bytes(int fd, const char *old, const char *new, long from, long to, long *changed)
+{
+    long i = from;
+
+    while (i < to)
+    {
+        if (old[i] == new[i])
+        {
+            i++;
+            continue;
+        }
+
+        long start = i, end = i + 1, gap = 0;
+        for (i++; i < to && gap < UPDATE_MERGE_GAP; i++)
+        {
+            if (old[i] != new[i])
+            {
+                end = i + 1;
+                gap = 0;
+                (*changed)++;
+            }
+            else
+                gap++;
+        }
+        (*changed)++;
+        i = end;
+
+        if (pwrite(fd, new + start, end - start, 54 + start) != end - start)
+        {
+            perror("pwrite");
+            return e_failure;
+        }
+    }
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * do_update
+ * Master function for the in-place update.
+ * -------------------------------------------------------------------*/
+Status do_update(EncodeInfo *encInfo)
+{
+    Status status = e_failure;
+    char *data = NULL, *old = NULL, *new = NULL;
+
+    printf("\n🚀 ============= UPDATE PROCESS STARTED ============= 🚀\n");
+
+    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "r+b");
+    if (encInfo->fptr_stego_image == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open %s\n", encInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    encInfo->fptr_secret = fopen(encInfo->secret_fname, "rb");
+    if (encInfo->fptr_secret == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open %s\n", encInfo->secret_fname);
+        fclose(encInfo->fptr_stego_image);
+        return e_failure;
+    }
+
+    FILE *fptr = encInfo->fptr_stego_image;
+    const char *file_extn = strrchr(encInfo->secret_fname, '.');
+    long extn_size = strlen(file_extn);
+    long image_size = get_file_size(fptr);
+
+    encInfo->image_capacity = get_image_size_for_bmp(fptr);
+    encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
+
+    long old_extn_size = 0;
+    long old_span = read_old_payload_span(fptr, image_size, &old_extn_size);
+    long new_span = get_payload_span(extn_size, encInfo->size_secret_file);
+
+    /*
+     * Header = magic .. size field, under both the old and the new layout,
+     * so a longer or shorter extension never leaves header bytes in the
+     * data pass that reaches the disk first
+     */
+    long header_span = get_payload_span(extn_size > old_extn_size ? extn_size : old_extn_size, 0);
+    long region = old_span > new_span ? old_span : new_span;
+
+    if (old_span == 0)
+        printf("❌ ERROR: %s is not a stego image.\n", encInfo->stego_image_fname);
+    else if (encInfo->image_capacity <= get_required_capacity(extn_size, encInfo->size_secret_file)
+             || 54 + new_span > image_size)
+        printf("❌ ERROR: Image does NOT have enough capacity!\n");
+    else if ((data = malloc(encInfo->size_secret_file + 1)) && (old = malloc(region)) && (new = malloc(region)))
+    {
+        long changed = 0;
+        int fd = fileno(fptr);
+
+        rewind(encInfo->fptr_secret);
+        if (fread(data, 1, encInfo->size_secret_file, encInfo->fptr_secret) == encInfo->size_secret_file
+            && pread(fd, old, region, 54) == region)
+        {
+            memcpy(new, old, region);
+            encode_payload_to_buffer(file_extn, data, encInfo->size_secret_file, new);
+
+            /* Data region first, header last (after the data reached the disk) */
+            if (write_changed_bytes(fd, old, new, header_span, region, &changed) == e_success
+                && fdatasync(fd) == 0
+                && write_changed_bytes(fd, old, new, 0, header_span, &changed) == e_success
+                && fdatasync(fd) == 0)
+            {
+                printf("✏️  Image bytes rewritten : %ld of %ld in payload region\n", changed, region);
+                status = e_success;
+            }
+        }
+    }
+
+    free(new);
+    free(old);
+    free(data);
+    fclose(encInfo->fptr_secret);
+    fclose(fptr);
+
+    if (status == e_success)
+        printf("\n🎉 Update Completed Successfully!\n");
+    else
+        printf("❌ Update failed.\n");
+
+    return status;
+}
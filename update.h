@@ -0,0 +1,16 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include "types.h"
+#include "encode.h"
+
+/* Changed image bytes closer than this are written with one pwrite */
+#define UPDATE_MERGE_GAP 16
+
+/* Update Encode args: -u <stego.bmp> <new_secret.ext> */
+Status read_and_validate_update_args(char *argv[], EncodeInfo *encInfo);
+
+/* Rewrite only the image bytes whose LSBs change for the new secret */
+Status do_update(EncodeInfo *encInfo);
+
+#endif
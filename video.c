@@ -0,0 +1,511 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "video.h"
+#include "encode.h"
+
+/*
+ * YUV4MPEG2 (Y4M) carriers. A stream is one header line followed by
+ * frames, each a "FRAME" line and the raw planes (Y, then U and V).
+ * The payload (magic, extn size, extn, size, data) is LSB coded over
+ * the plane bytes of consecutive frames, frame_len / 8 bytes per frame;
+ * the header has to fit in the first frame. Frames past the payload
+ * are copied through untouched.
+ */
+
+/* ---------------------------------------------------------------------
+ * open_video
+ * "-" (or no name for the output) selects stdin / stdout.
+ * -------------------------------------------------------------------*/
+static FILE *open_video(const char *fname, const char *mode, FILE *std)
+{
+    if (fname == NULL || strcmp(fname, "-") == 0)
+        return std;
+
+    return fopen(fname, mode);
+}
+
+static void close_video(FILE *fptr)
+{
+    if (fptr && fptr != stdin && fptr != stdout)
+        fclose(fptr);
+}
+
+static int is_y4m_name(const char *fname)
+{
+    int len = strlen(fname);
+
+    return strcmp(fname, "-") == 0 || (len > 4 && strcmp(fname + len - 4, ".y4m") == 0);
+}
+
+/* ---------------------------------------------------------------------
+ * read_and_validate_video_encode_args
+ * argv[2] : source video (.y4m or "-")
+ * argv[3] : secret file
+ * argv[4] : stego video (.y4m or "-", default stdout)
+ * -------------------------------------------------------------------*/
+Status read_and_validate_video_encode_args(int argc, char *argv[], VideoInfo *vidInfo)
+{
+    vidInfo->stego_fname = argc > 4 ? argv[4] : "-";
+    vidInfo->log = strcmp(vidInfo->stego_fname, "-") == 0 ? stderr : stdout;
+
+    if (!is_y4m_name(argv[2]) || !is_y4m_name(vidInfo->stego_fname))
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Videos must be \".y4m\" files or \"-\"\n");
+        return e_failure;
+    }
+
+    const char *extn = strrchr(argv[3], '.');
+    if (extn == NULL || strlen(extn) > VIDEO_MAX_EXTN)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Secret file must include a short extension (e.g., file.txt)\n");
+        return e_failure;
+    }
+
+    vidInfo->src_fname = argv[2];
+    vidInfo->secret_fname = argv[3];
+    strcpy(vidInfo->extn, extn);
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * read_and_validate_video_decode_args
+ * argv[2] : stego video (.y4m or "-")
+ * argv[3] : output name, extension taken from the payload
+ * -------------------------------------------------------------------*/
+Status read_and_validate_video_decode_args(int argc, char *argv[], VideoInfo *vidInfo)
+{
+    vidInfo->log = stdout;
+
+    if (!is_y4m_name(argv[2]))
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Stego video must be a \".y4m\" file or \"-\"\n");
+        return e_failure;
+    }
+
+    vidInfo->src_fname = argv[2];
+    snprintf(vidInfo->decoded_fname, sizeof(vidInfo->decoded_fname), "%s", argc > 3 ? argv[3] : "dec_data");
+
+    /* Remove extension, if present */
+    char *dot = strrchr(vidInfo->decoded_fname, '.');
+    if (dot && !strchr(dot, '/'))
+        *dot = '\0';
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * read_stream_header
+ * Parses "YUV4MPEG2 W<w> H<h> ... [C<colour>]" and sets the size of
+ * one frame. Only 8-bit planes are accepted.
+ * -------------------------------------------------------------------*/
+static Status read_stream_header(VideoInfo *vidInfo)
+{
+    char line[Y4M_LINE_MAX];
+    char colour[32] = "420";
+    char *save;
+
+    if (fgets(vidInfo->stream_header, sizeof(line), vidInfo->fptr_src) == NULL
+        || strncmp(vidInfo->stream_header, "YUV4MPEG2 ", 10) != 0
+        || strchr(vidInfo->stream_header, '\n') == NULL)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Not a YUV4MPEG2 stream\n");
+        return e_failure;
+    }
+
+    strcpy(line, vidInfo->stream_header);
+    vidInfo->width = vidInfo->height = 0;
+
+    for (char *tok = strtok_r(line + 10, " \n", &save); tok; tok = strtok_r(NULL, " \n", &save))
+    {
+        if (tok[0] == 'W')
+            vidInfo->width = atol(tok + 1);
+        else if (tok[0] == 'H')
+            vidInfo->height = atol(tok + 1);
+        else if (tok[0] == 'C')
+            snprintf(colour, sizeof(colour), "%s", tok + 1);
+    }
+
+    long luma = vidInfo->width * vidInfo->height;
+    long cw = (vidInfo->width + 1) / 2, ch = (vidInfo->height + 1) / 2;
+
+    if (strcmp(colour, "420") == 0 || strcmp(colour, "420jpeg") == 0
+        || strcmp(colour, "420paldv") == 0 || strcmp(colour, "420mpeg2") == 0)
+        vidInfo->frame_len = luma + 2 * cw * ch;
+    else if (strcmp(colour, "422") == 0)
+        vidInfo->frame_len = luma + 2 * cw * vidInfo->height;
+    else if (strcmp(colour, "444") == 0)
+        vidInfo->frame_len = 3 * luma;
+    else if (strcmp(colour, "444alpha") == 0)
+        vidInfo->frame_len = 4 * luma;
+    else if (strcmp(colour, "mono") == 0)
+        vidInfo->frame_len = luma;
+    else
+        vidInfo->frame_len = 0;
+
+    if (luma <= 0 || vidInfo->frame_len == 0)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Unsupported Y4M stream (%ldx%ld, C%s)\n",
+                vidInfo->width, vidInfo->height, colour);
+        return e_failure;
+    }
+
+    vidInfo->frame_data = vidInfo->frame_len / 8;
+
+    fprintf(vidInfo->log, "🎞️  %ldx%ld C%s : %ld bytes per frame, %ld payload bytes\n",
+            vidInfo->width, vidInfo->height, colour, vidInfo->frame_len, vidInfo->frame_data);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * read_frame
+ * Reads one "FRAME[ params]\n" line and its planes into buff.
+ * Returns the line length (where the planes start), 0 at the end of
+ * the stream, -1 on a broken frame.
+ * -------------------------------------------------------------------*/
+static long read_frame(VideoInfo *vidInfo, char *buff)
+{
+    if (fgets(buff, Y4M_LINE_MAX, vidInfo->fptr_src) == NULL)
+        return 0;
+
+    long line = strlen(buff);
+
+    if (strncmp(buff, "FRAME", 5) != 0 || buff[line - 1] != '\n'
+        || fread(buff + line, 1, vidInfo->frame_len, vidInfo->fptr_src) != vidInfo->frame_len)
+        return -1;
+
+    return line;
+}
+
+static long frame_block_len(void *ctx, long data_len)
+{
+    VideoInfo *vidInfo = ctx;
+
+    return Y4M_LINE_MAX + vidInfo->frame_len;
+}
+
+/* ---------------------------------------------------------------------
+ * Pipeline stages for do_video_encoding, one frame per slot
+ * read : next frame (carrier_pos = offset of its planes) and the
+ *        payload bytes it carries, payload header first
+ * embed: LSB encode them into the planes
+ * write: FRAME line and planes
+ * -------------------------------------------------------------------*/
+static Status read_frame_block(void *ctx, PipelineSlot *slot)
+{
+    VideoInfo *vidInfo = ctx;
+    long n = 0;
+
+    slot->carrier_pos = read_frame(vidInfo, slot->carrier);
+    if (slot->carrier_pos <= 0)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Video ended after %ld frame(s), payload does not fit\n", vidInfo->frames);
+        return e_failure;
+    }
+    vidInfo->frames++;
+
+    if (vidInfo->header_pos < vidInfo->header_len)
+    {
+        n = vidInfo->header_len - vidInfo->header_pos;
+        if (n > slot->data_len)
+            n = slot->data_len;
+        memcpy(slot->data, vidInfo->header + vidInfo->header_pos, n);
+        vidInfo->header_pos += n;
+    }
+
+    if (fread(slot->data + n, 1, slot->data_len - n, vidInfo->fptr_secret) != slot->data_len - n)
+        return e_failure;
+
+    return e_success;
+}
+
+static Status embed_frame_block(void *ctx, PipelineSlot *slot)
+{
+    return encode_block_to_lsb(slot->data, slot->data_len, slot->carrier + slot->carrier_pos, 0, NULL);
+}
+
+static Status write_frame_block(void *ctx, PipelineSlot *slot)
+{
+    VideoInfo *vidInfo = ctx;
+    long len = slot->carrier_pos + vidInfo->frame_len;
+
+    if (fwrite(slot->carrier, 1, len, vidInfo->fptr_stego) != len)
+        return e_failure;
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * build_payload_header
+ * magic, 32-bit extn size, extn, 64-bit size (most significant first)
+ * -------------------------------------------------------------------*/
+static void build_payload_header(VideoInfo *vidInfo)
+{
+    unsigned char *p = vidInfo->header;
+    long extn_len = strlen(vidInfo->extn);
+
+    memcpy(p, VIDEO_MAGIC_STRING, strlen(VIDEO_MAGIC_STRING));
+    p += strlen(VIDEO_MAGIC_STRING);
+
+    for (int i = 3; i >= 0; i--)
+        *p++ = extn_len >> (i * 8);
+
+    memcpy(p, vidInfo->extn, extn_len);
+    p += extn_len;
+
+    for (int i = 7; i >= 0; i--)
+        *p++ = vidInfo->size_secret_file >> (i * 8);
+
+    vidInfo->header_len = p - vidInfo->header;
+    vidInfo->header_pos = 0;
+}
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* ---------------------------------------------------------------------
+ * do_video_encoding
+ * -------------------------------------------------------------------*/
+Status do_video_encoding(VideoInfo *vidInfo)
+{
+    struct timespec start;
+    struct stat st;
+    char buff[64 * 1024];
+    size_t n;
+    Status status = e_failure;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vidInfo->frames = 0;
+
+    vidInfo->fptr_src = open_video(vidInfo->src_fname, "rb", stdin);
+    vidInfo->fptr_secret = fopen(vidInfo->secret_fname, "rb");
+    vidInfo->fptr_stego = NULL;
+
+    if (vidInfo->fptr_src == NULL || vidInfo->fptr_secret == NULL
+        || fstat(fileno(vidInfo->fptr_secret), &st) != 0)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Unable to open %s\n", vidInfo->fptr_src ? vidInfo->secret_fname : vidInfo->src_fname);
+    }
+    else if (read_stream_header(vidInfo) == e_success)
+    {
+        vidInfo->size_secret_file = st.st_size;
+        build_payload_header(vidInfo);
+
+        if (vidInfo->header_len > vidInfo->frame_data)
+        {
+            fprintf(vidInfo->log, "❌ ERROR: Frames too small for the payload header\n");
+        }
+        else if ((vidInfo->fptr_stego = open_video(vidInfo->stego_fname, "wb", stdout)) == NULL)
+        {
+            fprintf(vidInfo->log, "❌ ERROR: Unable to create %s\n", vidInfo->stego_fname);
+        }
+        else
+        {
+            PipelineStages stages = { read_frame_block, embed_frame_block, write_frame_block,
+                                      vidInfo, vidInfo->frame_data, frame_block_len };
+
+            fputs(vidInfo->stream_header, vidInfo->fptr_stego);
+
+            if (run_pipeline(&stages, vidInfo->header_len + vidInfo->size_secret_file,
+                             vidInfo->opts->pipeline_buffers) == e_success)
+            {
+                long payload_frames = vidInfo->frames;
+
+                /* Frames past the payload go through unchanged */
+                while ((n = fread(buff, 1, sizeof(buff), vidInfo->fptr_src)) > 0)
+                    if (fwrite(buff, 1, n, vidInfo->fptr_stego) != n)
+                        break;
+
+                if (fflush(vidInfo->fptr_stego) == 0 && !ferror(vidInfo->fptr_stego) && !ferror(vidInfo->fptr_src))
+                {
+                    double secs = elapsed_since(&start);
+
+                    fprintf(vidInfo->log, "🔐 %lld secret bytes in %ld frame(s), %.1f MB/s of frames\n",
+                            vidInfo->size_secret_file, payload_frames,
+                            secs > 0 ? payload_frames * (double)vidInfo->frame_len / secs / 1e6 : 0.0);
+                    status = e_success;
+                }
+            }
+
+            if (status != e_success)
+                fprintf(vidInfo->log, "❌ ERROR: Secret data could not be encoded.\n");
+        }
+    }
+
+    close_video(vidInfo->fptr_src);
+    close_video(vidInfo->fptr_stego);
+    if (vidInfo->fptr_secret)
+        fclose(vidInfo->fptr_secret);
+
+    if (status == e_success)
+        fprintf(vidInfo->log, "🎉 Video Encoding Completed Successfully!\n");
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * Pipeline stages for do_video_decoding, one frame per slot
+ * -------------------------------------------------------------------*/
+static Status read_stego_frame(void *ctx, PipelineSlot *slot)
+{
+    VideoInfo *vidInfo = ctx;
+
+    slot->carrier_pos = read_frame(vidInfo, slot->carrier);
+    if (slot->carrier_pos <= 0)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Video ended before the end of the payload\n");
+        return e_failure;
+    }
+
+    return e_success;
+}
+
+static Status extract_frame_block(void *ctx, PipelineSlot *slot)
+{
+    unsigned char *planes = (unsigned char *)slot->carrier + slot->carrier_pos;
+
+    for (long i = 0; i < slot->data_len; i++)
+        slot->data[i] = decode_byte_to_lsb(planes + i * 8);
+
+    return e_success;
+}
+
+static Status write_secret_frame(void *ctx, PipelineSlot *slot)
+{
+    VideoInfo *vidInfo = ctx;
+
+    if (fwrite(slot->data, 1, slot->data_len, vidInfo->fptr_secret) != slot->data_len)
+        return e_failure;
+
+    return e_success;
+}
+
+/* ---------------------------------------------------------------------
+ * decode_first_frame
+ * Extracts the payload header from the first frame, creates the
+ * output file and writes the secret bytes that frame carries.
+ * -------------------------------------------------------------------*/
+static Status decode_first_frame(VideoInfo *vidInfo, long long *left)
+{
+    char *frame = malloc(Y4M_LINE_MAX + vidInfo->frame_len);
+    unsigned char *data = malloc(vidInfo->frame_data);
+    int magic_len = strlen(VIDEO_MAGIC_STRING);
+    Status status = e_failure;
+    long line;
+
+    if (frame == NULL || data == NULL || (line = read_frame(vidInfo, frame)) <= 0)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Unable to read the first frame\n");
+        free(frame);
+        free(data);
+        return e_failure;
+    }
+
+    for (long i = 0; i < vidInfo->frame_data; i++)
+        data[i] = decode_byte_to_lsb((unsigned char *)frame + line + i * 8);
+
+    long extn_len = 0;
+    long long size = 0;
+
+    for (int i = 0; i < 4; i++)
+        extn_len = (extn_len << 8) | data[magic_len + i];
+
+    long pos = magic_len + 4 + extn_len;
+
+    if (memcmp(data, VIDEO_MAGIC_STRING, magic_len) != 0 || extn_len < 1
+        || extn_len > VIDEO_MAX_EXTN || pos + 8 > vidInfo->frame_data)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: No video payload found\n");
+    }
+    else
+    {
+        memcpy(vidInfo->extn, data + magic_len + 4, extn_len);
+        vidInfo->extn[extn_len] = '\0';
+
+        for (int i = 0; i < 8; i++)
+            size = (size << 8) | data[pos++];
+        if (size < 0)
+            size = 0;
+
+        long here = vidInfo->frame_data - pos;
+        if (size < here)
+            here = size;
+
+        size_t base = strlen(vidInfo->decoded_fname);
+        snprintf(vidInfo->decoded_fname + base, sizeof(vidInfo->decoded_fname) - base, "%s", vidInfo->extn);
+
+        fprintf(vidInfo->log, "📄 Final Output Filename : %s (%lld bytes)\n", vidInfo->decoded_fname, size);
+
+        vidInfo->size_secret_file = size;
+        vidInfo->fptr_secret = fopen(vidInfo->decoded_fname, "wb");
+
+        if (vidInfo->fptr_secret == NULL)
+            fprintf(vidInfo->log, "❌ ERROR: Unable to create file: %s\n", vidInfo->decoded_fname);
+        else if (fwrite(data + pos, 1, here, vidInfo->fptr_secret) == here)
+        {
+            *left = size - here;
+            status = e_success;
+        }
+    }
+
+    free(frame);
+    free(data);
+    return status;
+}
+
+/* ---------------------------------------------------------------------
+ * do_video_decoding
+ * -------------------------------------------------------------------*/
+Status do_video_decoding(VideoInfo *vidInfo)
+{
+    struct timespec start;
+    long long left = 0;
+    Status status = e_failure;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    vidInfo->fptr_secret = NULL;
+    vidInfo->fptr_src = open_video(vidInfo->src_fname, "rb", stdin);
+
+    if (vidInfo->fptr_src == NULL)
+    {
+        fprintf(vidInfo->log, "❌ ERROR: Unable to open %s\n", vidInfo->src_fname);
+    }
+    else if (read_stream_header(vidInfo) == e_success
+             && decode_first_frame(vidInfo, &left) == e_success)
+    {
+        PipelineStages stages = { read_stego_frame, extract_frame_block, write_secret_frame,
+                                  vidInfo, vidInfo->frame_data, frame_block_len };
+
+        if (left == 0 || run_pipeline(&stages, left, vidInfo->opts->pipeline_buffers) == e_success)
+        {
+            if (fflush(vidInfo->fptr_secret) == 0)
+            {
+                long frames = 1 + (left + vidInfo->frame_data - 1) / vidInfo->frame_data;
+                double secs = elapsed_since(&start);
+
+                fprintf(vidInfo->log, "🔓 %lld secret bytes from %ld frame(s), %.1f MB/s of frames\n",
+                        vidInfo->size_secret_file, frames,
+                        secs > 0 ? frames * (double)vidInfo->frame_len / secs / 1e6 : 0.0);
+                status = e_success;
+            }
+        }
+
+        if (status != e_success)
+            fprintf(vidInfo->log, "❌ ERROR: Secret data could not be decoded.\n");
+    }
+
+    close_video(vidInfo->fptr_src);
+    if (vidInfo->fptr_secret)
+        fclose(vidInfo->fptr_secret);
+
+    if (status == e_success)
+        fprintf(vidInfo->log, "🎉 Video Decoding Completed Successfully!\n");
+    return status;
+}
@@ -0,0 +1,67 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include <stdio.h>
+#include "types.h"
+#include "options.h"
+
+/* Longest stream header / FRAME line accepted */
+#define Y4M_LINE_MAX 1024
+
+/* Longest secret file extension stored in a video */
+#define VIDEO_MAX_EXTN 16
+
+/*
+ * One Y4M carrier job. Frames are read, embedded and written one
+ * at a time through the pipeline ring, so memory stays at a few
+ * frames whatever the length of the video. Each frame carries
+ * frame_len / 8 payload bytes (header first, then the secret).
+ */
+typedef struct _VideoInfo
+{
+    /* Video streams ("-" = stdin / stdout) */
+    const char *src_fname;
+    const char *stego_fname;
+    FILE *fptr_src;
+    FILE *fptr_stego;
+
+    /* Stream header line and the size of one frame's pixels */
+    char stream_header[Y4M_LINE_MAX];
+    long width;
+    long height;
+    long frame_len;
+    long frame_data;
+    long frames;
+
+    /* Secret file */
+    const char *secret_fname;
+    FILE *fptr_secret;
+    char extn[VIDEO_MAX_EXTN + 1];
+    long long size_secret_file;
+    char decoded_fname[4096];
+
+    /* Payload header (magic, extn size, extn, size) */
+    unsigned char header[4 + 4 + VIDEO_MAX_EXTN + 8];
+    long header_len;
+    long header_pos;
+
+    /* Progress messages (stderr when the video goes to stdout) */
+    FILE *log;
+
+    const StegoOptions *opts;
+
+} VideoInfo;
+
+/* Video encode args: -v <in.y4m|-> <secret.ext> [out.y4m|-] */
+Status read_and_validate_video_encode_args(int argc, char *argv[], VideoInfo *vidInfo);
+
+/* Video decode args: -V <in.y4m|-> [output_name] */
+Status read_and_validate_video_decode_args(int argc, char *argv[], VideoInfo *vidInfo);
+
+/* Embed the secret across consecutive frames, streaming the video through */
+Status do_video_encoding(VideoInfo *vidInfo);
+
+/* Extract the secret from a Y4M stream */
+Status do_video_decoding(VideoInfo *vidInfo);
+
+#endif